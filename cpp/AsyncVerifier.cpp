@@ -0,0 +1,142 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include <cassert>
+#include <cstdint>
+#include <memory>
+#include <utility>
+#include "AsyncVerifier.hpp"
+#include "Ecdsa.hpp"
+
+using std::size_t;
+using std::uint8_t;
+
+
+static const uint8_t ZERO_HASH[Sha256Hash::HASH_LEN] = {};
+
+
+AsyncVerifier::Request::Request() :
+	publicKey(CurvePoint::ZERO),
+	msgHash(ZERO_HASH, Sha256Hash::HASH_LEN),
+	r(Uint256::ZERO),
+	s(Uint256::ZERO) {}
+
+
+AsyncVerifier::AsyncVerifier(int numThreads, size_t capacity) :
+		ring(capacity),
+		numSleeping(0),
+		stopping(false) {
+	assert(numThreads >= 1);
+	for (int i = 0; i < numThreads; i++)
+		threads.emplace_back(&AsyncVerifier::workerLoop, this);
+}
+
+
+AsyncVerifier::~AsyncVerifier() {
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		stopping = true;
+	}
+	workAvailable.notify_all();
+	for (std::thread &th : threads)
+		th.join();
+}
+
+
+bool AsyncVerifier::trySubmit(const CurvePoint &publicKey, const Sha256Hash &msgHash,
+		const Uint256 &r, const Uint256 &s, Callback callback) {
+	Request req;
+	req.publicKey = publicKey;
+	req.msgHash = msgHash;
+	req.r = r;
+	req.s = s;
+	req.callback = std::move(callback);
+	return push(req);
+}
+
+
+void AsyncVerifier::submit(const CurvePoint &publicKey, const Sha256Hash &msgHash,
+		const Uint256 &r, const Uint256 &s, Callback callback) {
+	Request req;
+	req.publicKey = publicKey;
+	req.msgHash = msgHash;
+	req.r = r;
+	req.s = s;
+	req.callback = std::move(callback);
+	while (!push(req))
+		std::this_thread::yield();
+}
+
+
+std::future<bool> AsyncVerifier::submit(const CurvePoint &publicKey, const Sha256Hash &msgHash,
+		const Uint256 &r, const Uint256 &s) {
+	std::shared_ptr<std::promise<bool> > promise = std::make_shared<std::promise<bool> >();
+	std::future<bool> result = promise->get_future();
+	submit(publicKey, msgHash, r, s, [promise](bool valid) { promise->set_value(valid); });
+	return result;
+}
+
+
+size_t AsyncVerifier::getQueueLength() const {
+	return ring.getSize();
+}
+
+
+bool AsyncVerifier::push(Request &req) {
+	if (!ring.tryPush(req))
+		return false;
+	// Pairs with the increment of numSleeping, so that either this thread sees a sleeper
+	// or the sleeper sees the new request when it checks the ring under the mutex
+	std::atomic_thread_fence(std::memory_order_seq_cst);
+	if (numSleeping.load() > 0) {
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		workAvailable.notify_one();
+	}
+	return true;
+}
+
+
+void AsyncVerifier::workerLoop() {
+	std::vector<Request> batch(MICRO_BATCH_LEN);
+	std::vector<CurvePoint> publicKeys(MICRO_BATCH_LEN, CurvePoint::ZERO);
+	std::vector<Sha256Hash> msgHashes(MICRO_BATCH_LEN, Sha256Hash(ZERO_HASH, Sha256Hash::HASH_LEN));
+	std::vector<Uint256> rs(MICRO_BATCH_LEN);
+	std::vector<Uint256> ss(MICRO_BATCH_LEN);
+	std::unique_ptr<bool[]> results(new bool[MICRO_BATCH_LEN]);
+	while (true) {
+		// Take whatever is queued, up to the micro-batch length
+		size_t n = 0;
+		while (n < MICRO_BATCH_LEN && ring.tryPop(batch[n]))
+			n++;
+		
+		if (n > 0) {
+			for (size_t i = 0; i < n; i++) {
+				publicKeys[i] = batch[i].publicKey;
+				msgHashes[i] = batch[i].msgHash;
+				rs[i] = batch[i].r;
+				ss[i] = batch[i].s;
+			}
+			Ecdsa::verifyBatch(publicKeys.data(), msgHashes.data(), rs.data(), ss.data(), n, results.get());
+			for (size_t i = 0; i < n; i++) {
+				Callback callback = std::move(batch[i].callback);
+				batch[i].callback = nullptr;
+				if (callback)
+					callback(results[i]);
+			}
+			continue;
+		}
+		
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		numSleeping++;
+		// A request counted by getSize() may still be mid-push, so recheck instead of sleeping on it
+		workAvailable.wait(lock, [this]() { return stopping || ring.getSize() > 0; });
+		numSleeping--;
+		if (stopping && ring.getSize() == 0)
+			return;
+	}
+}
@@ -0,0 +1,123 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <functional>
+#include <future>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "CurvePoint.hpp"
+#include "MpmcRing.hpp"
+#include "Sha256Hash.hpp"
+#include "Uint256.hpp"
+
+
+/* 
+ * Verifies ECDSA signatures asynchronously, so that threads like a network handler can hand off checks without
+ * waiting. Requests go into a bounded lock-free MpmcRing, and worker threads drain it. Each worker takes up to
+ * MICRO_BATCH_LEN requests that are already queued and checks them together with Ecdsa::verifyBatch(), so the
+ * per-signature cost falls as the queue gets deeper, while a lone request is still handled at once. Results are
+ * delivered through a callback (run on a worker thread, so it should be quick) or a future.
+ * 
+ * Backpressure is chosen per call: trySubmit() rejects a request when the ring is full, and submit() waits for
+ * room. All methods may be called concurrently. Example usage:
+ *   AsyncVerifier verifier(2, 4096);
+ *   if (!verifier.trySubmit(pubKey, msgHash, r, s, [](bool valid) { ... }))
+ *     ... overloaded, so drop or defer the message ...
+ *   std::future<bool> result = verifier.submit(pubKey, msgHash, r, s);
+ */
+class AsyncVerifier final {
+	
+	/*---- Public constants ----*/
+	
+	public: static constexpr std::size_t MICRO_BATCH_LEN = 64;  // Most requests verified together
+	
+	
+	
+	/*---- Types ----*/
+	
+	// Receives whether the signature is valid.
+	public: typedef std::function<void(bool)> Callback;
+	
+	private: struct Request {
+		CurvePoint publicKey;
+		Sha256Hash msgHash;
+		Uint256 r;
+		Uint256 s;
+		Callback callback;
+		
+		Request();
+	};
+	
+	
+	
+	/*---- Fields ----*/
+	
+	private: MpmcRing<Request> ring;
+	private: std::vector<std::thread> threads;
+	
+	private: std::mutex sleepMutex;  // Guards stopping and the waits on the condition variable
+	private: std::condition_variable workAvailable;
+	private: std::atomic<int> numSleeping;
+	private: bool stopping;
+	
+	
+	
+	/*---- Constructors ----*/
+	
+	// Starts the given number of worker threads (at least 1) with a ring of the given capacity,
+	// which must be a power of 2 and at least 2.
+	public: explicit AsyncVerifier(int numThreads, std::size_t capacity);
+	
+	
+	// Finishes all queued requests (running their callbacks), then stops the worker threads.
+	// No submission may be in progress or happen afterward.
+	public: ~AsyncVerifier();
+	
+	
+	public: AsyncVerifier(const AsyncVerifier &other) = delete;
+	
+	public: AsyncVerifier &operator=(const AsyncVerifier &other) = delete;
+	
+	
+	
+	/*---- Methods ----*/
+	
+	// Queues a check of the given signature, whose callback later receives what Ecdsa::verify() returns.
+	// The public key must be normalized. Returns false without queueing if the ring is full. Never blocks.
+	public: bool trySubmit(const CurvePoint &publicKey, const Sha256Hash &msgHash,
+		const Uint256 &r, const Uint256 &s, Callback callback);
+	
+	
+	// Same as trySubmit(), but waits (yielding the processor) for room in the ring instead of failing.
+	public: void submit(const CurvePoint &publicKey, const Sha256Hash &msgHash,
+		const Uint256 &r, const Uint256 &s, Callback callback);
+	
+	
+	// Same as the other submit(), but returns a future for the result instead of taking a callback.
+	public: std::future<bool> submit(const CurvePoint &publicKey, const Sha256Hash &msgHash,
+		const Uint256 &r, const Uint256 &s);
+	
+	
+	// Returns the number of requests waiting in the ring. Only a snapshot, for monitoring and load shedding.
+	public: std::size_t getQueueLength() const;
+	
+	
+	// Moves the request into the ring and wakes a worker if needed. Returns false if the ring is full.
+	private: bool push(Request &req);
+	
+	
+	// The main loop of each worker thread.
+	private: void workerLoop();
+	
+};
@@ -0,0 +1,77 @@
+/* 
+ * A runnable main program that tests the functionality of class AsyncVerifier.
+ * 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include "TestHelper.hpp"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <future>
+#include <thread>
+#include "AsyncVerifier.hpp"
+
+
+// Global variables
+static int numTestCases = 0;
+
+
+/*---- Test cases ----*/
+
+static void testFutures(const vector<TestSignature> &sigs) {
+	AsyncVerifier verifier(2, 8);  // Small ring, so submit() must wait for room
+	vector<std::future<bool> > results;
+	for (const TestSignature &sig : sigs)
+		results.push_back(verifier.submit(sig.publicKey, sig.msgHash, sig.r, sig.s));
+	for (size_t i = 0; i < sigs.size(); i++) {
+		assert(results[i].get() == sigs[i].valid);
+		numTestCases++;
+	}
+}
+
+
+static void testCallbacksAndBackpressure(const vector<TestSignature> &sigs) {
+	const int numProducers = 3;
+	std::atomic<int> numCorrect(0);
+	std::atomic<int> numRejected(0);
+	{
+		AsyncVerifier verifier(2, 16);
+		vector<std::thread> producers;
+		for (int t = 0; t < numProducers; t++) {
+			producers.emplace_back([&verifier, &sigs, &numCorrect, &numRejected]() {
+				for (const TestSignature &sig : sigs) {
+					const bool expect = sig.valid;
+					AsyncVerifier::Callback callback = [&numCorrect, expect](bool valid) {
+						if (valid == expect)
+							numCorrect++;
+					};
+					if (!verifier.trySubmit(sig.publicKey, sig.msgHash, sig.r, sig.s, callback)) {
+						numRejected++;
+						verifier.submit(sig.publicKey, sig.msgHash, sig.r, sig.s, callback);
+					}
+				}
+			});
+		}
+		for (std::thread &th : producers)
+			th.join();
+	}  // The destructor finishes the queued requests
+	assert(numCorrect.load() == numProducers * static_cast<int>(sigs.size()));
+	assert(numRejected.load() > 0);  // The producers outpace verification
+	numTestCases++;
+}
+
+
+int main() {
+	vector<TestSignature> sigs;
+	for (unsigned int i = 0; i < 60; i++)
+		sigs.push_back(makeTestSignature(i, i % 5 != 2));
+	testFutures(sigs);
+	testCallbacksAndBackpressure(sigs);
+	std::printf("All %d test cases passed\n", numTestCases);
+	return EXIT_SUCCESS;
+}
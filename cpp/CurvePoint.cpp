@@ -7,11 +7,21 @@
  */
 
 #include <cassert>
+#include <cstring>
+#include "AsmX8664.hpp"
 #include "CountOps.hpp"
 #include "CurvePoint.hpp"
+#if defined(__AVX2__)
+	#include <immintrin.h>
+#elif defined(__SSE2__)
+	#include <emmintrin.h>
+#endif
 
+using std::int8_t;
+using std::size_t;
 using std::uint8_t;
 using std::uint32_t;
+using std::uint64_t;
 
 
 CurvePoint::CurvePoint(const FieldInt &x_, const FieldInt &y_) :
@@ -66,18 +76,56 @@ void CurvePoint::add(const CurvePoint &other) {
 	temp.replace(*this, static_cast<uint32_t>(otherZero));
 	temp.replace(other, static_cast<uint32_t>(thisZero ));
 	
+	bool sameX, sameY;
+	addDistinct(other, false, sameX, sameY);
+	temp.replace(ZERO, static_cast<uint32_t>(!thisZero & !otherZero & sameX & !sameY));
+	
+	this->replace(temp, static_cast<uint32_t>(thisZero | otherZero | sameX));
+	countOps(6 * arithmeticOps);
+	countOps(1 * curvepointCopyOps);
+}
+
+
+void CurvePoint::addVartime(const CurvePoint &other) {
+	// Same result as add(), but the special cases are handled by branching,
+	// so that the common case does not pay for the speculative doubling
+	countOps(functionOps);
+	if (other.isZero())
+		return;
+	if (this->isZero()) {
+		*this = other;
+		countOps(1 * curvepointCopyOps);
+		return;
+	}
+	const CurvePoint old = *this;
+	bool sameX, sameY;
+	addDistinct(other, other.z == FI_ONE, sameX, sameY);
+	countOps(1 * arithmeticOps);
+	countOps(1 * curvepointCopyOps);
+	if (sameX) {
+		*this = sameY ? old : ZERO;  // Doubling or inverse pair
+		countOps(1 * curvepointCopyOps);
+		if (sameY)
+			this->twice();
+	}
+}
+
+
+void CurvePoint::addDistinct(const CurvePoint &other, bool otherNormalized, bool &sameX, bool &sameY) {
+	countOps(functionOps);
 	FieldInt u0 = this->x;
 	FieldInt u1 = other.x;
 	FieldInt t0 = this->y;
 	FieldInt &t1 = x;  // Reuse memory
 	t1 = other.y;
-	u0.multiply(other.z);
+	if (!otherNormalized) {  // Otherwise multiplying by other.z = 1 changes nothing
+		u0.multiply(other.z);
+		t0.multiply(other.z);
+	}
 	u1.multiply(this->z);
-	t0.multiply(other.z);
 	t1.multiply(this->z);
-	bool sameX = u0 == u1;
-	bool sameY = t0 == t1;
-	temp.replace(ZERO, static_cast<uint32_t>(!thisZero & !otherZero & sameX & !sameY));
+	sameX = u0 == u1;
+	sameY = t0 == t1;
 	
 	FieldInt &t = y;  // Reuse memory
 	t = t0;
@@ -87,7 +135,8 @@ void CurvePoint::add(const CurvePoint &other) {
 	FieldInt u2 = u;
 	u2.square();
 	FieldInt &v = z;  // Reuse memory
-	v.multiply(other.z);
+	if (!otherNormalized)
+		v.multiply(other.z);
 	
 	FieldInt w = t;
 	w.square();
@@ -110,11 +159,8 @@ void CurvePoint::add(const CurvePoint &other) {
 	t.subtract(t0);  // Assigns to y
 	
 	v.multiply(u3);  // Assigns to z
-	
-	this->replace(temp, static_cast<uint32_t>(thisZero | otherZero | sameX));
-	countOps(8 * arithmeticOps);
+	countOps(2 * arithmeticOps);
 	countOps(10 * fieldintCopyOps);
-	countOps(1 * curvepointCopyOps);
 }
 
 
@@ -183,39 +229,88 @@ void CurvePoint::twice() {
 }
 
 
+template <int W>
 void CurvePoint::multiply(const Uint256 &n) {
-	// Precompute [this*0, this*1, ..., this*15]
-	countOps(functionOps);
-	constexpr int tableBits = 4;  // Do not modify
-	constexpr unsigned int tableLen = 1U << tableBits;
-	CurvePoint table[tableLen];  // Default-initialized with ZERO
-	table[1] = *this;
-	table[2] = *this;
-	countOps(18 * curvepointCopyOps);
-	table[2].twice();
-	for (unsigned int i = 3; i < tableLen; i++) {
+	/* 
+	 * Algorithm pseudocode:
+	 * table = [this*1, this*2, ..., this*2^(W-1)]
+	 * result = 0
+	 * for each W-bit window (i = top .. 0) {
+	 *   d = Booth digit of n at bit i*W, in the range [-2^(W-1), 2^(W-1)]
+	 *   result = result * 2^W + sign(d) * table[abs(d) - 1]
+	 * }
+	 */
+	static_assert(1 <= W && W <= 8, "Unsupported window width");
+	countOps(functionOps);
+	constexpr int tableLen = 1 << (W - 1);
+	CurvePoint table[tableLen];
+	precomputeMultiples(*this, table, tableLen);
+	
+	// Process W bits per iteration (windowed method with signed digits)
+	constexpr int numBits = Uint256::NUM_WORDS * 32;
+	*this = ZERO;
+	countOps(1 * curvepointCopyOps);
+	for (int i = numBits / W * W; i >= 0; i -= W) {
 		countOps(loopBodyOps);
-		table[i] = table[i - 1];
-		table[i].add(*this);
-		countOps(2 * arithmeticOps);
+		this->add(selectSigned(table, tableLen, getBoothDigit(n, i, W), 0));
+		if (i != 0) {
+			for (int j = 0; j < W; j++) {
+				countOps(loopBodyOps);
+				this->twice();
+			}
+		}
+	}
+}
+
+template void CurvePoint::multiply<1>(const Uint256 &n);
+template void CurvePoint::multiply<2>(const Uint256 &n);
+template void CurvePoint::multiply<3>(const Uint256 &n);
+template void CurvePoint::multiply<4>(const Uint256 &n);
+template void CurvePoint::multiply<5>(const Uint256 &n);
+template void CurvePoint::multiply<6>(const Uint256 &n);
+template void CurvePoint::multiply<7>(const Uint256 &n);
+template void CurvePoint::multiply<8>(const Uint256 &n);
+
+
+void CurvePoint::multiplyGlv(const Uint256 &n) {
+	/* 
+	 * Algorithm pseudocode:
+	 * (n1, neg1, n2, neg2) = splitScalar(n)
+	 * table1 = [this*1, this*2, ..., this*8]
+	 * table2 = [endo(t) for t in table1]
+	 * result = 0
+	 * for each 4-bit window (i = 128, 124, ..., 0) {
+	 *   d1 = Booth digit of n1 at bit i, d2 = Booth digit of n2 at bit i
+	 *   result = result * 16 + (-1)^neg1 * sign(d1) * table1[abs(d1) - 1]
+	 *                        + (-1)^neg2 * sign(d2) * table2[abs(d2) - 1]
+	 * }
+	 */
+	countOps(functionOps);
+	Uint256 n1, n2;
+	uint32_t neg1, neg2;
+	splitScalar(n, n1, neg1, n2, neg2);
+	countOps(2 * uint256CopyOps);
+	
+	// Precompute [this*1, this*2, ..., this*8] and its image under the endomorphism
+	constexpr int tableBits = 4;
+	constexpr int tableLen = 1 << (tableBits - 1);
+	CurvePoint table1[tableLen];
+	precomputeMultiples(*this, table1, tableLen);
+	CurvePoint table2[tableLen];
+	for (int i = 0; i < tableLen; i++) {
+		countOps(loopBodyOps);
+		table2[i] = table1[i];
 		countOps(1 * curvepointCopyOps);
 	}
+	applyEndomorphism(table2, tableLen);
 	
-	// Process tableBits per iteration (windowed method)
+	// Process tableBits of both halves per iteration (windowed method with signed digits)
 	*this = ZERO;
 	countOps(1 * curvepointCopyOps);
-	for (int i = Uint256::NUM_WORDS * 32 - tableBits; i >= 0; i -= tableBits) {
+	for (int i = 128; i >= 0; i -= tableBits) {
 		countOps(loopBodyOps);
-		unsigned int inc = (n.value[i >> 5] >> (i & 31)) & (tableLen - 1);
-		CurvePoint q = ZERO;  // Dummy initial value
-		countOps(5 * arithmeticOps);
-		countOps(1 * curvepointCopyOps);
-		for (unsigned int j = 0; j < tableLen; j++) {
-			countOps(loopBodyOps);
-			q.replace(table[j], static_cast<uint32_t>(j == inc));
-			countOps(1 * arithmeticOps);
-		}
-		this->add(q);
+		this->add(selectSigned(table1, tableLen, getBoothDigit(n1, i, tableBits), neg1));
+		this->add(selectSigned(table2, tableLen, getBoothDigit(n2, i, tableBits), neg2));
 		if (i != 0) {
 			for (int j = 0; j < tableBits; j++) {
 				countOps(loopBodyOps);
@@ -226,6 +321,109 @@ void CurvePoint::multiply(const Uint256 &n) {
 }
 
 
+bool CurvePoint::multiplyX(const Uint256 &n, FieldInt &outX) const {
+	/* 
+	 * Montgomery ladder on (X : Z) with the invariant r1 - r0 = this = (xd : zd), where a = 0.
+	 * Differential addition (Brier-Joye), r0 + r1 = (X3 : Z3):
+	 *   X3 = zd * ((X0 * X1)^2 - 4b * Z0 * Z1 * (X0 * Z1 + X1 * Z0))
+	 *   Z3 = xd * (X0 * Z1 - X1 * Z0)^2
+	 * Doubling, 2 * r = (X' : Z'):
+	 *   X' = X^4 - 8b * X * Z^3
+	 *   Z' = 4 * Z * (X^3 + b * Z^3)
+	 * Algorithm pseudocode:
+	 * (r0, r1) = (zero = (1 : 0), this)
+	 * for (i = 255 .. 0) {
+	 *   if (n.bit[i] == 0) (r0, r1) = (2 * r0, r0 + r1)
+	 *   else               (r0, r1) = (r0 + r1, 2 * r1)
+	 * }
+	 * return r0.X / r0.Z
+	 * The formulas handle the point at infinity as r0 without special cases, because no curve
+	 * point has x = 0 (B = 7 is not a square modulo the field prime), so xd != 0.
+	 */
+	countOps(functionOps);
+	const FieldInt &xd = x;
+	const FieldInt &zd = z;
+	FieldInt x0 = FI_ONE;
+	FieldInt z0 = FI_ZERO;
+	FieldInt x1 = xd;
+	FieldInt z1 = zd;
+	countOps(4 * fieldintCopyOps);
+	
+	uint32_t prevBit = 0;
+	countOps(1 * arithmeticOps);
+	for (int i = Uint256::NUM_WORDS * 32 - 1; i >= 0; i--) {
+		countOps(loopBodyOps);
+		// Conditionally swap so that r0 is always the point being doubled
+		uint32_t bit = (n.value[i >> 5] >> (i & 31)) & 1;
+		uint32_t swap = bit ^ prevBit;
+		prevBit = bit;
+		FieldInt t = x0;
+		x0.replace(x1, swap);
+		x1.replace(t, swap);
+		t = z0;
+		z0.replace(z1, swap);
+		z1.replace(t, swap);
+		countOps(6 * arithmeticOps);
+		countOps(2 * fieldintCopyOps);
+		
+		// r1 = r0 + r1
+		FieldInt x0z1 = x0;
+		x0z1.multiply(z1);
+		FieldInt x1z0 = x1;
+		x1z0.multiply(z0);
+		FieldInt z0z1 = z0;
+		z0z1.multiply(z1);
+		x1.multiply(x0);
+		x1.square();
+		FieldInt u = x0z1;
+		u.add(x1z0);
+		u.multiply(z0z1);
+		multiplyByB(u);
+		u.multiply2();
+		u.multiply2();
+		x1.subtract(u);
+		x1.multiply(zd);
+		z1 = x0z1;
+		z1.subtract(x1z0);
+		z1.square();
+		z1.multiply(xd);
+		countOps(5 * fieldintCopyOps);
+		
+		// r0 = 2 * r0, as X' = X * (X^3 - 8b * Z^3) and Z' = 4 * Z * (X^3 + b * Z^3)
+		FieldInt xxx = x0;
+		xxx.square();
+		xxx.multiply(x0);  // X^3
+		FieldInt bzzz = z0;
+		bzzz.square();
+		bzzz.multiply(z0);
+		multiplyByB(bzzz);  // b * Z^3
+		FieldInt v = bzzz;
+		v.multiply2();
+		v.multiply2();
+		v.multiply2();
+		FieldInt w = xxx;
+		w.subtract(v);
+		x0.multiply(w);
+		bzzz.add(xxx);
+		z0.multiply(bzzz);
+		z0.multiply2();
+		z0.multiply2();
+		countOps(4 * fieldintCopyOps);
+	}
+	x0.replace(x1, prevBit);  // Undo the last swap
+	z0.replace(z1, prevBit);
+	
+	bool isZeroResult = isZero() | (z0 == FI_ZERO);
+	z0.reciprocal();
+	x0.multiply(z0);
+	x0.replace(FI_ZERO, static_cast<uint32_t>(isZeroResult));
+	outX = x0;
+	countOps(2 * arithmeticOps);
+	countOps(1 * fieldintCopyOps);
+	return !isZeroResult;
+}
+
+
 void CurvePoint::normalize() {
 	/* 
 	 * Algorithm pseudocode:
@@ -253,6 +451,16 @@ void CurvePoint::normalize() {
 }
 
 
+void CurvePoint::negate() {
+	countOps(functionOps);
+	FieldInt negY = FI_ZERO;
+	negY.subtract(y);
+	y.replace(negY, static_cast<uint32_t>(!isZero()));
+	countOps(1 * fieldintCopyOps);
+	countOps(1 * arithmeticOps);
+}
+
+
 void CurvePoint::replace(const CurvePoint &other, uint32_t enable) {
 	assert((enable >> 1) == 0);
 	countOps(functionOps);
@@ -286,8 +494,19 @@ bool CurvePoint::isZero() const {
 
 bool CurvePoint::operator==(const CurvePoint &other) const {
 	countOps(functionOps);
-	countOps(2 * arithmeticOps);
-	return (x == other.x) & (y == other.y) & (z == other.z);
+	bool thisZero  = this->isZero();
+	bool otherZero = other.isZero();
+	FieldInt x1 = this->x;
+	FieldInt y1 = this->y;
+	FieldInt x2 = other.x;
+	FieldInt y2 = other.y;
+	x1.multiply(other.z);
+	y1.multiply(other.z);
+	x2.multiply(this->z);
+	y2.multiply(this->z);
+	countOps(4 * fieldintCopyOps);
+	countOps(7 * arithmeticOps);
+	return (thisZero & otherZero) | (!thisZero & !otherZero & (x1 == x2) & (y1 == y2));
 }
 
 bool CurvePoint::operator!=(const CurvePoint &other) const {
@@ -297,6 +516,36 @@ bool CurvePoint::operator!=(const CurvePoint &other) const {
 }
 
 
+bool CurvePoint::hasXModOrder(const Uint256 &r) const {
+	/* 
+	 * Algorithm pseudocode:
+	 * if (this == ZERO) return false
+	 * if (r * z == x) return true
+	 * return r + ORDER < modulus && (r + ORDER) * z == x
+	 */
+	assert(r < ORDER);
+	countOps(functionOps);
+	if (isZero())
+		return false;
+	FieldInt t(r);  // Exact, because ORDER < modulus
+	t.multiply(z);
+	countOps(1 * fieldintCopyOps);
+	if (t == x)
+		return true;
+	
+	Uint256 r2 = r;
+	uint32_t carry = r2.add(ORDER);
+	FieldInt t2(r2);
+	countOps(3 * arithmeticOps);
+	countOps(1 * uint256CopyOps);
+	countOps(1 * fieldintCopyOps);
+	if (carry != 0 || Uint256(t2) != r2)  // r + ORDER is not less than the modulus
+		return false;
+	t2.multiply(z);
+	return t2 == x;
+}
+
+
 void CurvePoint::toCompressedPoint(uint8_t output[33]) const {
 	assert(output != nullptr);
 	output[0] = static_cast<uint8_t>((y.value[0] & 1) + 0x02);
@@ -304,15 +553,669 @@ void CurvePoint::toCompressedPoint(uint8_t output[33]) const {
 }
 
 
+void CurvePoint::toUncompressedPoint(uint8_t output[65]) const {
+	assert(output != nullptr);
+	output[0] = 0x04;
+	x.getBigEndianBytes(&output[1]);
+	y.getBigEndianBytes(&output[33]);
+}
+
+
+bool CurvePoint::fromBytes(const uint8_t bytes[], size_t len, CurvePoint &outPoint) {
+	countOps(functionOps);
+	if (bytes == nullptr || len == 0)
+		return false;
+	uint8_t header = bytes[0];
+	bool compressed = len == 33 && (header == 0x02 || header == 0x03);
+	bool uncompressed = len == 65 && (header == 0x04 || header == 0x06 || header == 0x07);
+	if (!compressed && !uncompressed)
+		return false;
+	countOps(12 * arithmeticOps);
+	
+	// Reject coordinates that are not less than the modulus
+	const Uint256 xRaw(&bytes[1]);
+	const FieldInt x(xRaw);
+	if (Uint256(x) != xRaw)
+		return false;
+	countOps(2 * uint256CopyOps);
+	countOps(1 * fieldintCopyOps);
+	
+	if (compressed) {
+		// y = sqrt(x^3 + B) with the requested parity. The result is never zero,
+		// because the curve has no point of order 2 (its order is prime).
+		FieldInt y = x;
+		y.square();
+		y.multiply(x);
+		y.add(B);
+		if (!y.sqrt())
+			return false;
+		FieldInt negY = FI_ZERO;
+		negY.subtract(y);
+		y.replace(negY, static_cast<uint32_t>((y.value[0] ^ header) & 1));
+		outPoint = CurvePoint(x, y);
+		countOps(3 * arithmeticOps);
+		countOps(2 * fieldintCopyOps);
+		countOps(1 * curvepointCopyOps);
+		return true;
+	} else {
+		const Uint256 yRaw(&bytes[33]);
+		const FieldInt y(yRaw);
+		if (Uint256(y) != yRaw || (header != 0x04 && (y.value[0] & 1) != (header & 1U)))
+			return false;
+		const CurvePoint p(x, y);
+		if (!p.isOnCurve())
+			return false;
+		outPoint = p;
+		countOps(6 * arithmeticOps);
+		countOps(2 * uint256CopyOps);
+		countOps(1 * fieldintCopyOps);
+		countOps(2 * curvepointCopyOps);
+		return true;
+	}
+}
+
+
+size_t CurvePoint::fromBytesBulk(const uint8_t data[], size_t keyLen, size_t n, CurvePoint outPoints[], bool outValid[]) {
+	assert((data != nullptr && outPoints != nullptr && outValid != nullptr) || n == 0);
+	countOps(functionOps);
+	size_t result = 0;
+	for (size_t i = 0; i < n; i++) {
+		countOps(loopBodyOps);
+		outPoints[i] = ZERO;
+		outValid[i] = fromBytes(&data[i * keyLen], keyLen, outPoints[i]);
+		if (outValid[i])
+			result++;
+		countOps(4 * arithmeticOps);
+		countOps(1 * curvepointCopyOps);
+	}
+	return result;
+}
+
+
 CurvePoint CurvePoint::privateExponentToPublicPoint(const Uint256 &privExp) {
 	assert((Uint256::ZERO < privExp) & (privExp < CurvePoint::ORDER));
-	CurvePoint result = CurvePoint::G;
-	result.multiply(privExp);
+	CurvePoint result = multiplyGenerator(privExp);
 	result.normalize();
 	return result;
 }
 
 
+CurvePoint CurvePoint::doubleMultiply(const Uint256 &u1, const CurvePoint &p, const Uint256 &u2, const CurvePoint &q) {
+	/* 
+	 * Algorithm pseudocode:
+	 * (a1, a2) = splitScalar(u1), (b1, b2) = splitScalar(u2)
+	 * tables = [odd multiples of p, endo(p), q, endo(q)]
+	 * return straussMultiply([a1, a2, b1, b2], tables)
+	 */
+	countOps(functionOps);
+	constexpr int width = DOUBLE_MULTIPLY_WINDOW;
+	constexpr int tableLen = 1 << (width - 2);
+	CurvePoint tables[4][tableLen];
+	precomputeOddMultiples(p, tables[0], tableLen);
+	precomputeOddMultiples(q, tables[2], tableLen);
+	for (int i = 0; i < tableLen; i++) {
+		countOps(loopBodyOps);
+		tables[1][i] = tables[0][i];
+		tables[3][i] = tables[2][i];
+		countOps(2 * curvepointCopyOps);
+	}
+	applyEndomorphism(tables[1], tableLen);
+	applyEndomorphism(tables[3], tableLen);
+	
+	Uint256 scalars[4];
+	uint32_t negs[4];
+	splitScalar(u1, scalars[0], negs[0], scalars[1], negs[1]);
+	splitScalar(u2, scalars[2], negs[2], scalars[3], negs[3]);
+	const CurvePoint *const tablePtrs[] = {tables[0], tables[1], tables[2], tables[3]};
+	const int widths[] = {width, width, width, width};
+	return straussMultiply(4, scalars, negs, tablePtrs, widths);
+}
+
+
+void CurvePoint::precomputeDoubleMultiplyTable(const CurvePoint &q, CurvePoint table[PRECOMPUTED_TABLE_LEN]) {
+	assert(table != nullptr);
+	countOps(functionOps);
+	constexpr int half = PRECOMPUTED_TABLE_LEN / 2;
+	precomputeOddMultiples(q, table, half);
+	for (int i = 0; i < half; i++) {
+		countOps(loopBodyOps);
+		table[half + i] = table[i];
+		countOps(1 * curvepointCopyOps);
+	}
+	applyEndomorphism(&table[half], half);
+}
+
+
+CurvePoint CurvePoint::doubleMultiplyPrecomputed(const Uint256 &u1, const Uint256 &u2, const CurvePoint table[PRECOMPUTED_TABLE_LEN]) {
+	assert(table != nullptr);
+	countOps(functionOps);
+	const CurvePoint *gTable = getGeneratorDoubleMultiplyTable();
+	Uint256 scalars[4];
+	uint32_t negs[4];
+	splitScalar(u1, scalars[0], negs[0], scalars[1], negs[1]);
+	splitScalar(u2, scalars[2], negs[2], scalars[3], negs[3]);
+	constexpr int half = PRECOMPUTED_TABLE_LEN / 2;
+	const CurvePoint *const tablePtrs[] = {&gTable[0], &gTable[half], &table[0], &table[half]};
+	const int widths[] = {PRECOMPUTED_WINDOW, PRECOMPUTED_WINDOW, PRECOMPUTED_WINDOW, PRECOMPUTED_WINDOW};
+	return straussMultiply(4, scalars, negs, tablePtrs, widths);
+}
+
+
+CurvePoint CurvePoint::doubleMultiplyGenerator(const Uint256 &u1, const Uint256 &u2, const CurvePoint &q) {
+	countOps(functionOps);
+	const CurvePoint *gTable = getGeneratorDoubleMultiplyTable();
+	constexpr int width = DOUBLE_MULTIPLY_WINDOW;
+	constexpr int tableLen = 1 << (width - 2);
+	CurvePoint tables[2][tableLen];
+	precomputeOddMultiples(q, tables[0], tableLen);
+	for (int i = 0; i < tableLen; i++) {
+		countOps(loopBodyOps);
+		tables[1][i] = tables[0][i];
+		countOps(1 * curvepointCopyOps);
+	}
+	applyEndomorphism(tables[1], tableLen);
+	
+	Uint256 scalars[4];
+	uint32_t negs[4];
+	splitScalar(u1, scalars[0], negs[0], scalars[1], negs[1]);
+	splitScalar(u2, scalars[2], negs[2], scalars[3], negs[3]);
+	constexpr int half = PRECOMPUTED_TABLE_LEN / 2;
+	const CurvePoint *const tablePtrs[] = {&gTable[0], &gTable[half], tables[0], tables[1]};
+	const int widths[] = {PRECOMPUTED_WINDOW, PRECOMPUTED_WINDOW, width, width};
+	return straussMultiply(4, scalars, negs, tablePtrs, widths);
+}
+
+
+void CurvePoint::precomputeGeneratorTable(CurvePoint table[GENERATOR_TABLE_LEN]) {
+	assert(table != nullptr);
+	constexpr int width = GENERATOR_TABLE_WINDOW;
+	constexpr int tableLen = 1 << (width - 1);
+	CurvePoint base = G;  // 2^(i*W) * G
+	for (int i = 0; i < GENERATOR_TABLE_LEN; i += tableLen) {
+		precomputeMultiples(base, &table[i], tableLen);
+		for (int j = 0; j < tableLen; j++)
+			table[i + j].normalize();
+		for (int j = 0; j < width; j++)
+			base.twice();
+	}
+}
+
+
+CurvePoint CurvePoint::multiplyGenerator(const Uint256 &n, const CurvePoint table[GENERATOR_TABLE_LEN]) {
+	assert(table != nullptr);
+	countOps(functionOps);
+	constexpr int width = GENERATOR_TABLE_WINDOW;
+	constexpr int tableLen = 1 << (width - 1);
+	CurvePoint result = ZERO;
+	countOps(1 * curvepointCopyOps);
+	for (int i = 0; i * tableLen < GENERATOR_TABLE_LEN; i++) {
+		countOps(loopBodyOps);
+		result.add(selectSigned(&table[i * tableLen], tableLen, getBoothDigit(n, i * width, width), 0));
+	}
+	return result;
+}
+
+
+CurvePoint CurvePoint::multiplyGenerator(const Uint256 &n) {
+	const CurvePoint *table = generatorTable.load();
+	if (table != nullptr)
+		return multiplyGenerator(n, table);
+	CurvePoint result = G;
+	result.multiplyGlv(n);
+	return result;
+}
+
+
+void CurvePoint::setGeneratorTable(const CurvePoint *table) {
+	generatorTable.store(table);
+}
+
+
+const CurvePoint *CurvePoint::getGeneratorDoubleMultiplyTable() {
+	// Built on first use instead of as a static initializer, because the FieldInt
+	// constants in another translation unit might not be initialized yet then
+	struct Table {
+		CurvePoint points[PRECOMPUTED_TABLE_LEN];
+		Table() {
+			precomputeDoubleMultiplyTable(G, points);
+			for (CurvePoint &p : points)  // So that additions of these points are cheaper
+				p.normalize();
+		}
+	};
+	static const Table table;  // Thread-safe initialization
+	return table.points;
+}
+
+
+void CurvePoint::splitScalar(const Uint256 &n, Uint256 &n1, uint32_t &neg1, Uint256 &n2, uint32_t &neg2) {
+	/* 
+	 * Algorithm pseudocode (all arithmetic on signed integers):
+	 * k = n % ORDER
+	 * c1 = round(k * G1 / 2^384)
+	 * c2 = round(k * G2 / 2^384)
+	 * k1 = k - c1 * A1 - c2 * A2
+	 * k2 = c1 * MINUS_B1 - c2 * B2
+	 * Both k1 and k2 are guaranteed to be in the range (-2^128, 2^128), so it suffices
+	 * to compute them modulo 2^256 and then take the sign and magnitude from two's complement.
+	 */
+	countOps(functionOps);
+	Uint256 k = n;
+	k.subtract(ORDER, static_cast<uint32_t>(k >= ORDER));
+	countOps(1 * uint256CopyOps);
+	
+	constexpr int numWords = Uint256::NUM_WORDS;
+	uint32_t product[numWords * 2];
+	Uint256 c[2];
+	const Uint256 *gs[] = {&GLV_G1, &GLV_G2};
+	for (int i = 0; i < 2; i++) {
+		countOps(loopBodyOps);
+		multiplyFull(k, *gs[i], product);
+		// Shift right by 384 bits with rounding; the quotient fits in 128 bits
+		uint32_t carry = product[numWords + numWords / 2 - 1] >> 31;
+		for (int j = 0; j < numWords; j++) {
+			countOps(loopBodyOps);
+			uint64_t sum = carry;
+			if (j < numWords / 2)
+				sum += product[numWords + numWords / 2 + j];
+			c[i].value[j] = static_cast<uint32_t>(sum);
+			carry = static_cast<uint32_t>(sum >> 32);
+			countOps(6 * arithmeticOps);
+		}
+	}
+	
+	Uint256 temp;
+	n1 = k;
+	multiplyFull(c[0], GLV_A1, product);
+	std::memcpy(temp.value, product, sizeof(temp.value));
+	n1.subtract(temp);
+	multiplyFull(c[1], GLV_A2, product);
+	std::memcpy(temp.value, product, sizeof(temp.value));
+	n1.subtract(temp);
+	
+	multiplyFull(c[0], GLV_MINUS_B1, product);
+	std::memcpy(n2.value, product, sizeof(n2.value));
+	multiplyFull(c[1], GLV_B2, product);
+	std::memcpy(temp.value, product, sizeof(temp.value));
+	n2.subtract(temp);
+	countOps(5 * uint256CopyOps);
+	
+	// Convert from two's complement to sign and magnitude
+	neg1 = n1.value[numWords - 1] >> 31;
+	neg2 = n2.value[numWords - 1] >> 31;
+	temp = Uint256::ZERO;
+	temp.subtract(n1);
+	n1.replace(temp, neg1);
+	temp = Uint256::ZERO;
+	temp.subtract(n2);
+	n2.replace(temp, neg2);
+	assert((n1.value[4] | n1.value[5] | n1.value[6] | n1.value[7]) == 0);
+	assert((n2.value[4] | n2.value[5] | n2.value[6] | n2.value[7]) == 0);
+	countOps(4 * arithmeticOps);
+	countOps(2 * uint256CopyOps);
+}
+
+
+CurvePoint CurvePoint::multiScalarMultiply(const Uint256 scalars[], const CurvePoint points[], size_t n,
+		CurvePoint scratch[], size_t scratchLen) {
+	/* 
+	 * Algorithm pseudocode (Pippenger's bucket method):
+	 * c = window width, B = 2^(c-1) buckets
+	 * result = 0
+	 * for (w = ceil(257 / c) - 1 .. 0) {
+	 *   result = result * 2^c
+	 *   buckets = [0] * B
+	 *   for each i:
+	 *     d = Booth digit of scalars[i] at bit w*c
+	 *     buckets[abs(d) - 1] += sign(d) * points[i]
+	 *   result += sum((j + 1) * buckets[j] for each j)  // As a running sum from the top
+	 * }
+	 */
+	assert((scalars != nullptr && points != nullptr && scratch != nullptr && scratchLen >= 1) || n == 0);
+	countOps(functionOps);
+	CurvePoint result = ZERO;
+	countOps(1 * curvepointCopyOps);
+	if (n == 0)
+		return result;
+	
+	constexpr int numBits = Uint256::NUM_WORDS * 32;
+	const int width = getMultiScalarWindow(n, scratchLen);
+	const int numBuckets = 1 << (width - 1);
+	const int numWindows = (numBits + width) / width;  // ceil((numBits + 1) / width)
+	countOps(5 * arithmeticOps);
+	for (int w = numWindows - 1; w >= 0; w--) {
+		countOps(loopBodyOps);
+		for (int i = 0; i < width; i++) {
+			countOps(loopBodyOps);
+			result.twice();
+		}
+		for (int j = 0; j < numBuckets; j++) {
+			countOps(loopBodyOps);
+			scratch[j] = ZERO;
+			countOps(1 * curvepointCopyOps);
+		}
+		
+		for (size_t i = 0; i < n; i++) {
+			countOps(loopBodyOps);
+			int d = getBoothDigit(scalars[i], w * width, width);
+			countOps(2 * arithmeticOps);
+			if (d > 0)
+				scratch[d - 1].addVartime(points[i]);
+			else if (d < 0) {
+				CurvePoint t = points[i];
+				t.negate();
+				scratch[-d - 1].addVartime(t);
+				countOps(2 * arithmeticOps);
+				countOps(1 * curvepointCopyOps);
+			}
+		}
+		
+		CurvePoint running = ZERO;
+		CurvePoint sum = ZERO;
+		countOps(2 * curvepointCopyOps);
+		for (int j = numBuckets - 1; j >= 0; j--) {
+			countOps(loopBodyOps);
+			running.addVartime(scratch[j]);
+			sum.addVartime(running);
+		}
+		result.addVartime(sum);
+	}
+	return result;
+}
+
+
+size_t CurvePoint::multiScalarScratchLen(size_t n) {
+	countOps(functionOps);
+	countOps(2 * arithmeticOps);
+	return static_cast<size_t>(1) << (getMultiScalarWindow(n, SIZE_MAX) - 1);
+}
+
+
+CurvePoint CurvePoint::straussMultiply(int count, const Uint256 scalars[], const uint32_t negs[],
+		const CurvePoint *const tables[], const int widths[]) {
+	/* 
+	 * Algorithm pseudocode:
+	 * nafs = [wNAF(scalars[i], widths[i]) for each i]
+	 * result = 0
+	 * for (j = max(len(nafs)) - 1 .. 0) {
+	 *   result = result * 2
+	 *   for each i where nafs[i][j] != 0:
+	 *     result += sign(nafs[i][j]) * (-1)^negs[i] * tables[i][abs(nafs[i][j]) / 2]
+	 * }
+	 */
+	assert(0 <= count && count <= STRAUSS_MAX_TERMS);
+	countOps(functionOps);
+	int8_t nafs[STRAUSS_MAX_TERMS][WNAF_MAX_LEN];
+	int maxLen = 0;
+	for (int i = 0; i < count; i++) {
+		countOps(loopBodyOps);
+		int len = computeWnaf(scalars[i], widths[i], nafs[i]);
+		if (negs[i] != 0) {
+			for (int j = 0; j < len; j++)
+				nafs[i][j] = static_cast<int8_t>(-nafs[i][j]);
+		}
+		if (len > maxLen)
+			maxLen = len;
+		countOps(3 * arithmeticOps);
+	}
+	
+	CurvePoint result = ZERO;
+	countOps(1 * curvepointCopyOps);
+	for (int j = maxLen - 1; j >= 0; j--) {
+		countOps(loopBodyOps);
+		result.twice();
+		for (int i = 0; i < count; i++) {
+			countOps(loopBodyOps);
+			int d = nafs[i][j];
+			countOps(1 * arithmeticOps);
+			if (d == 0)
+				continue;
+			CurvePoint t = tables[i][(d < 0 ? -d : d) >> 1];
+			if (d < 0)
+				t.negate();
+			result.addVartime(t);
+			countOps(4 * arithmeticOps);
+			countOps(1 * curvepointCopyOps);
+		}
+	}
+	return result;
+}
+
+
+void CurvePoint::precomputeOddMultiples(const CurvePoint &p, CurvePoint table[], int len) {
+	assert(table != nullptr && len >= 1);
+	countOps(functionOps);
+	CurvePoint p2 = p;
+	p2.twice();
+	table[0] = p;
+	countOps(2 * curvepointCopyOps);
+	for (int i = 1; i < len; i++) {
+		countOps(loopBodyOps);
+		table[i] = table[i - 1];
+		table[i].addVartime(p2);
+		countOps(1 * curvepointCopyOps);
+	}
+}
+
+
+void CurvePoint::precomputeMultiples(const CurvePoint &p, CurvePoint table[], int len) {
+	assert(table != nullptr && len >= 1);
+	countOps(functionOps);
+	table[0] = p;
+	countOps(1 * curvepointCopyOps);
+	for (int i = 1; i < len; i++) {
+		countOps(loopBodyOps);
+		table[i] = table[i - 1];
+		if (i == 1)
+			table[i].twice();
+		else
+			table[i].add(p);
+		countOps(1 * curvepointCopyOps);
+	}
+}
+
+
+CurvePoint CurvePoint::selectSigned(const CurvePoint table[], int len, int digit, uint32_t flip) {
+	/* 
+	 * Streams linearly through the table, treating each entry as 24 words (x, y, z) and blending it into the
+	 * result under an all-ones or all-zeros mask. Uses AVX2 (one 256-bit blend per coordinate) or SSE2 (two
+	 * 128-bit and/andnot/or per coordinate) when the compiler targets them, otherwise 32-bit word masking.
+	 */
+	static_assert(sizeof(CurvePoint) == 3 * Uint256::NUM_WORDS * 4, "Unexpected padding");
+	assert(table != nullptr && -len <= digit && digit <= len && (flip >> 1) == 0);
+	countOps(functionOps);
+	uint32_t sign = static_cast<uint32_t>(digit) >> 31;
+	uint32_t mag = (static_cast<uint32_t>(digit) ^ (0 - sign)) + sign;
+	CurvePoint result = ZERO;
+	countOps(5 * arithmeticOps);
+	countOps(1 * curvepointCopyOps);
+	
+	uint32_t *const dest[] = {result.x.value, result.y.value, result.z.value};
+#if defined(__AVX2__)
+	__m256i acc[3];
+	for (int j = 0; j < 3; j++)
+		acc[j] = _mm256_loadu_si256(reinterpret_cast<const __m256i *>(dest[j]));
+	for (int i = 0; i < len; i++) {
+		countOps(loopBodyOps);
+		const __m256i mask = _mm256_set1_epi32(-static_cast<int32_t>(static_cast<uint32_t>(i + 1) == mag));
+		const uint32_t *const src[] = {table[i].x.value, table[i].y.value, table[i].z.value};
+		for (int j = 0; j < 3; j++)
+			acc[j] = _mm256_blendv_epi8(acc[j], _mm256_loadu_si256(reinterpret_cast<const __m256i *>(src[j])), mask);
+		countOps(5 * arithmeticOps);
+	}
+	for (int j = 0; j < 3; j++)
+		_mm256_storeu_si256(reinterpret_cast<__m256i *>(dest[j]), acc[j]);
+#elif defined(__SSE2__)
+	__m128i acc[6];
+	for (int j = 0; j < 6; j++)
+		acc[j] = _mm_loadu_si128(reinterpret_cast<const __m128i *>(dest[j >> 1] + (j & 1) * 4));
+	for (int i = 0; i < len; i++) {
+		countOps(loopBodyOps);
+		const __m128i mask = _mm_set1_epi32(-static_cast<int32_t>(static_cast<uint32_t>(i + 1) == mag));
+		const uint32_t *const src[] = {table[i].x.value, table[i].y.value, table[i].z.value};
+		for (int j = 0; j < 6; j++) {
+			__m128i val = _mm_loadu_si128(reinterpret_cast<const __m128i *>(src[j >> 1] + (j & 1) * 4));
+			acc[j] = _mm_or_si128(_mm_andnot_si128(mask, acc[j]), _mm_and_si128(mask, val));
+		}
+		countOps(5 * arithmeticOps);
+	}
+	for (int j = 0; j < 6; j++)
+		_mm_storeu_si128(reinterpret_cast<__m128i *>(dest[j >> 1] + (j & 1) * 4), acc[j]);
+#else
+	for (int i = 0; i < len; i++) {
+		countOps(loopBodyOps);
+		const uint32_t mask = -static_cast<uint32_t>(static_cast<uint32_t>(i + 1) == mag);
+		const uint32_t *const src[] = {table[i].x.value, table[i].y.value, table[i].z.value};
+		for (int j = 0; j < 3; j++) {
+			for (int k = 0; k < Uint256::NUM_WORDS; k++)
+				dest[j][k] = (dest[j][k] & ~mask) | (src[j][k] & mask);
+		}
+		countOps(5 * arithmeticOps);
+	}
+#endif
+	
+	CurvePoint neg = result;
+	neg.negate();
+	result.replace(neg, sign ^ flip);
+	countOps(1 * arithmeticOps);
+	countOps(1 * curvepointCopyOps);
+	return result;
+}
+
+
+void CurvePoint::applyEndomorphism(CurvePoint table[], int len) {
+	assert(table != nullptr && len >= 0);
+	countOps(functionOps);
+	for (int i = 0; i < len; i++) {
+		countOps(loopBodyOps);
+		table[i].x.multiply(BETA);
+	}
+}
+
+
+void CurvePoint::multiplyByB(FieldInt &val) {
+	// 7 * val = 8 * val - val
+	countOps(functionOps);
+	const FieldInt orig = val;
+	val.multiply2();
+	val.multiply2();
+	val.multiply2();
+	val.subtract(orig);
+	countOps(1 * fieldintCopyOps);
+}
+
+
+void CurvePoint::multiplyFull(const Uint256 &x, const Uint256 &y, uint32_t product[Uint256::NUM_WORDS * 2]) {
+	assert(product != nullptr);
+	countOps(functionOps);
+	constexpr int numWords = Uint256::NUM_WORDS;
+	if (USE_X8664_ASM_IMPL) {
+		asm_FieldInt_multiply256x256eq512(product, &x.value[0], &y.value[0]);
+		countOps(105 * arithmeticOps);
+		return;
+	}
+	
+	for (int i = 0; i < numWords * 2; i++)
+		product[i] = 0;
+	countOps(numWords * 2 * arithmeticOps);
+	for (int i = 0; i < numWords; i++) {
+		countOps(loopBodyOps);
+		uint32_t carry = 0;
+		countOps(1 * arithmeticOps);
+		for (int j = 0; j < numWords; j++) {
+			countOps(loopBodyOps);
+			uint64_t sum = static_cast<uint64_t>(x.value[i]) * y.value[j];
+			sum += static_cast<uint64_t>(product[i + j]) + carry;  // Does not overflow
+			product[i + j] = static_cast<uint32_t>(sum);
+			carry = static_cast<uint32_t>(sum >> 32);
+			countOps(11 * arithmeticOps);
+		}
+		product[i + numWords] = carry;
+		countOps(1 * arithmeticOps);
+	}
+}
+
+
+int CurvePoint::computeWnaf(const Uint256 &n, int width, int8_t naf[WNAF_MAX_LEN]) {
+	/* 
+	 * Scans the bits from low to high while carrying a pending +1. At each position where the
+	 * (bit + carry) is odd, emits a digit made from the next 'width' bits, choosing the negative
+	 * representative when the digit's top bit is set, and carries 1 into the next window.
+	 */
+	assert(naf != nullptr && 2 <= width && width <= 8);
+	countOps(functionOps);
+	constexpr int numBits = Uint256::NUM_WORDS * 32;
+	for (int i = 0; i < WNAF_MAX_LEN; i++)
+		naf[i] = 0;
+	
+	int result = 0;
+	uint32_t carry = 0;
+	for (int bit = 0; bit < numBits; ) {
+		countOps(loopBodyOps);
+		uint32_t word = n.value[bit >> 5] >> (bit & 31);
+		if ((bit & 31) + width > 32 && (bit >> 5) + 1 < Uint256::NUM_WORDS)
+			word |= n.value[(bit >> 5) + 1] << (32 - (bit & 31));
+		countOps(8 * arithmeticOps);
+		if ((word & 1) == carry) {
+			bit++;
+			continue;
+		}
+		int now = numBits - bit < width ? numBits - bit : width;
+		word = (word & ((1U << now) - 1)) + carry;  // Odd, and less than 2^width
+		carry = (word >> (width - 1)) & 1;
+		naf[bit] = static_cast<int8_t>(static_cast<int>(word) - static_cast<int>(carry << width));
+		result = bit + 1;
+		bit += now;
+		countOps(12 * arithmeticOps);
+	}
+	if (carry != 0) {
+		naf[numBits] = 1;
+		result = numBits + 1;
+	}
+	return result;
+}
+
+
+int CurvePoint::getBoothDigit(const Uint256 &n, int pos, int width) {
+	/* 
+	 * Let u be the (width + 1) bits of n from position pos - 1 up to pos + width - 1.
+	 * The digit is bits[pos .. pos+width-1] + bit[pos-1] - 2^width * bit[pos+width-1],
+	 * so that the top bit of each window is borrowed back by the next window.
+	 */
+	assert(0 <= pos && 1 <= width && width <= 30);
+	countOps(functionOps);
+	constexpr int numBits = Uint256::NUM_WORDS * 32;
+	uint32_t u = 0;
+	for (int i = 0; i <= width; i++) {
+		countOps(loopBodyOps);
+		int bit = pos - 1 + i;
+		if (0 <= bit && bit < numBits)
+			u |= ((n.value[bit >> 5] >> (bit & 31)) & 1) << i;
+		countOps(8 * arithmeticOps);
+	}
+	countOps(6 * arithmeticOps);
+	return static_cast<int>((u >> 1) + (u & 1)) - static_cast<int>((u >> width) << width);
+}
+
+
+int CurvePoint::getMultiScalarWindow(size_t n, size_t scratchLen) {
+	// Minimizes the approximate number of additions, ceil(257 / c) * (n + 2^c), over the window width c
+	countOps(functionOps);
+	constexpr int numBits = Uint256::NUM_WORDS * 32;
+	int result = 1;
+	double bestCost = -1;
+	for (int c = 1; c <= MULTI_SCALAR_MAX_WINDOW && (static_cast<size_t>(1) << (c - 1)) <= scratchLen; c++) {
+		countOps(loopBodyOps);
+		double cost = static_cast<double>((numBits + c) / c) * (static_cast<double>(n) + (1 << c));
+		if (bestCost < 0 || cost < bestCost) {
+			result = c;
+			bestCost = cost;
+		}
+		countOps(10 * arithmeticOps);
+	}
+	return result;
+}
+
+
 // Static initializers
 const FieldInt CurvePoint::FI_ZERO("0000000000000000000000000000000000000000000000000000000000000000");
 const FieldInt CurvePoint::FI_ONE ("0000000000000000000000000000000000000000000000000000000000000001");
@@ -323,3 +1226,12 @@ const CurvePoint CurvePoint::G(
 	FieldInt("79BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798"),
 	FieldInt("483ADA7726A3C4655DA4FBFC0E1108A8FD17B448A68554199C47D08FFB10D4B8"));
 const CurvePoint CurvePoint::ZERO;  // Default constructor
+const FieldInt CurvePoint::BETA ("7AE96A2B657C07106E64479EAC3434E99CF0497512F58995C1396C28719501EE");
+const Uint256  CurvePoint::LAMBDA("5363AD4CC05C30E0A5261C028812645A122E22EA20816678DF02967C1B23BD72");
+const Uint256  CurvePoint::GLV_A1      ("000000000000000000000000000000003086D221A7D46BCDE86C90E49284EB15");
+const Uint256  CurvePoint::GLV_MINUS_B1("00000000000000000000000000000000E4437ED6010E88286F547FA90ABFE4C3");
+const Uint256  CurvePoint::GLV_A2      ("0000000000000000000000000000000114CA50F7A8E2F3F657C1108D9D44CFD8");
+const Uint256  CurvePoint::GLV_B2      ("000000000000000000000000000000003086D221A7D46BCDE86C90E49284EB15");
+const Uint256  CurvePoint::GLV_G1("3086D221A7D46BCDE86C90E49284EB153DAA8A1471E8CA7FE893209A45DBB031");
+const Uint256  CurvePoint::GLV_G2("E4437ED6010E88286F547FA90ABFE4C4221208AC9DF506C61571B4AE8AC47F71");
+std::atomic<const CurvePoint *> CurvePoint::generatorTable(nullptr);
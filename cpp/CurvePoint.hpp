@@ -8,6 +8,8 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstddef>
 #include <cstdint>
 #include "FieldInt.hpp"
 #include "Uint256.hpp"
@@ -18,7 +20,7 @@
  * Contains methods for computing point addition, doubling, and multiplication, and testing equality.
  * The ordinary affine coordinates of a point is (x/z, y/z). Instances of this class are mutable.
  * 
- * Points MUST be normalized before comparing for equality. Example of correct usage:
+ * Equality compares the represented points, so normalization is not needed first. Example usage:
  *   CurvePoint a(...);
  *   CurvePoint b(...);
  *   CurvePoint c(...);
@@ -26,12 +28,20 @@
  *   a.add(b);
  *   a.multiply(50);
  *   
- *   a.normalize();
- *   c.normalize();
  *   if (a == c) { ... }
+ *   a.normalize();  // Needed before serialization
  */
 class CurvePoint final {
 	
+	/*---- Public constants ----*/
+	
+	public: static constexpr int PRECOMPUTED_WINDOW = 8;  // wNAF width used with a precomputed point table
+	public: static constexpr int PRECOMPUTED_TABLE_LEN = 2 << (PRECOMPUTED_WINDOW - 2);  // Odd multiples of a point and of its endomorphism image
+	public: static constexpr int GENERATOR_TABLE_WINDOW = 8;  // Booth window width of the fixed-base table for G
+	public: static constexpr int GENERATOR_TABLE_LEN = (256 / GENERATOR_TABLE_WINDOW + 1) << (GENERATOR_TABLE_WINDOW - 1);  // Multiples of G in all windows
+	
+	
+	
 	/*---- Fields ----*/
 	
 	public: FieldInt x;
@@ -67,9 +77,29 @@ class CurvePoint final {
 	public: void twice();
 	
 	
-	// Multiplies this point by the given unsigned integer. The resulting state
-	// is usually not normalized. Constant-time with respect to both values.
-	public: void multiply(const Uint256 &n);
+	// Multiplies this point by the given unsigned integer. The scalar is recoded into signed W-bit windows
+	// with digits in [-2^(W-1), 2^(W-1)] (Booth recoding), so the lookup table holds only 2^(W-1) multiples
+	// and negative digits are applied by a conditional y negation. W is a tuning parameter; the instantiations
+	// for 1 <= W <= 8 are available. The resulting state is usually not normalized. Constant-time with
+	// respect to both values.
+	public: template <int W = 4> void multiply(const Uint256 &n);
+	
+	
+	// Multiplies this point by the given unsigned integer using the secp256k1 endomorphism (GLV method).
+	// The scalar is split as n = n1 + n2 * LAMBDA (mod ORDER) where n1 and n2 have magnitudes below 2^128,
+	// so that only half as many doublings are needed as in multiply(). This point must be on the curve or
+	// be zero. The resulting state is usually not normalized. Constant-time with respect to both values.
+	public: void multiplyGlv(const Uint256 &n);
+	
+	
+	// Computes only the affine x coordinate of n times this point, using an x-only Montgomery ladder over
+	// (X : Z) coordinates, as needed for ECDH. The working set is a few field elements, with no table; that
+	// memory saving is its main advantage, since it costs only about 10% less than multiply() and about 20% more
+	// than multiplyGlv() followed by normalize(), which should be preferred when a few kilobytes of stack are available.
+	// This point must be on the curve, and need not be normalized. Returns true and sets outX if the result
+	// is not zero; otherwise sets outX to zero and returns false (also if this point is zero). Constant-time
+	// with respect to both values (all 256 bits of n are processed).
+	public: bool multiplyX(const Uint256 &n, FieldInt &outX) const;
 	
 	
 	// Normalizes the coordinates of this point. Idempotent operation.
@@ -77,6 +107,11 @@ class CurvePoint final {
 	public: void normalize();
 	
 	
+	// Negates this point, i.e. sets y to -y. The zero point is left unchanged. The
+	// normalization state is preserved. Constant-time with respect to this value.
+	public: void negate();
+	
+	
 	// Copies the given point into this point if enable is 1, or does nothing if enable is 0.
 	// Constant-time with respect to both values and the enable.
 	public: void replace(const CurvePoint &other, std::uint32_t enable);
@@ -95,27 +130,206 @@ class CurvePoint final {
 	public: bool isZero() const;
 	
 	
-	// Tests whether this point equals the given point in all 3 coordinates. This comparison is
-	// meaningful only if both points are normalized. Constant-time with respect to both values.
+	// Tests whether this point and the given point represent the same point, by comparing (x1 * z2, y1 * z2)
+	// with (x2 * z1, y2 * z1). Neither point needs to be normalized. Both points must be on the curve or be zero.
+	// Constant-time with respect to both values.
 	public: bool operator==(const CurvePoint &other) const;
 	
-	// Tests whether this point mismatches the given point in any of the 3 coordinates. This comparison
-	// is meaningful only if both points are normalized. Constant-time with respect to both values.
+	// Tests whether this point and the given point represent different points; the negation of operator==().
+	// Neither point needs to be normalized. Both points must be on the curve or be zero.
+	// Constant-time with respect to both values.
 	public: bool operator!=(const CurvePoint &other) const;
 	
 	
+	// Tests whether this point is not zero and its affine x coordinate, reduced modulo ORDER, equals r. Requires
+	// r < ORDER. This is done without normalization, by checking r * z == x and, in the rare case that r + ORDER
+	// is less than the field modulus, (r + ORDER) * z == x. This is the final check of ECDSA verification.
+	// Not constant-time.
+	public: bool hasXModOrder(const Uint256 &r) const;
+	
+	
 	// Serializes this point in compressed format (header byte, x-coordinate in big-endian).
 	// This point needs to be normalized before the method is called. Constant-time with respect to this value.
 	public: void toCompressedPoint(std::uint8_t output[33]) const;
 	
 	
+	// Serializes this point in uncompressed format (header byte 0x04, x-coordinate, y-coordinate, both in big-endian).
+	// This point needs to be normalized before the method is called. Constant-time with respect to this value.
+	public: void toUncompressedPoint(std::uint8_t output[65]) const;
+	
+	
 	/*---- Static functions ----*/
 	
+	// Parses the given SEC 1 encoding of a point: compressed (33 bytes, header 0x02 or 0x03), uncompressed
+	// (65 bytes, header 0x04), or hybrid (65 bytes, header 0x06 or 0x07, which must match the parity of y).
+	// If the length, header, and coordinates are valid and the point is on the curve, then outPoint is set to
+	// the normalized point and true is returned. Otherwise outPoint is unchanged and false is returned. The point
+	// at infinity is never accepted. Decompression uses FieldInt::sqrt(). Not constant-time.
+	public: static bool fromBytes(const std::uint8_t bytes[], std::size_t len, CurvePoint &outPoint);
+	
+	
+	// Parses n encodings that are each keyLen bytes long and stored consecutively in data, as by fromBytes().
+	// Sets outPoints[i] to the parsed point (or to ZERO if invalid) and outValid[i] to whether it was valid,
+	// and returns the number of valid encodings. Not constant-time.
+	public: static std::size_t fromBytesBulk(const std::uint8_t data[], std::size_t keyLen, std::size_t n,
+		CurvePoint outPoints[], bool outValid[]);
+	
+	
 	// Returns a normalized public curve point for the given private exponent key.
 	// Requires 0 < privExp < ORDER. Constant-time with respect to the value.
 	public: static CurvePoint privateExponentToPublicPoint(const Uint256 &privExp);
 	
 	
+	// Returns the point u1 * p + u2 * q, where both points must be on the curve or be zero. Each scalar is split
+	// with the endomorphism (see splitScalar()), and the resulting four half-length multiplications are interleaved
+	// over a single shared chain of about 128 doublings (Strauss-Shamir trick), using a width-5 NAF table of
+	// odd multiples for each point. The result is usually not normalized. This is meant for signature
+	// verification. Not constant-time, so all inputs must be public values.
+	public: static CurvePoint doubleMultiply(const Uint256 &u1, const CurvePoint &p, const Uint256 &u2, const CurvePoint &q);
+	
+	
+	// Fills the given table with the odd multiples of q and of its endomorphism image, for use with
+	// doubleMultiplyPrecomputed(). The point q must be on the curve. Not constant-time.
+	public: static void precomputeDoubleMultiplyTable(const CurvePoint &q, CurvePoint table[PRECOMPUTED_TABLE_LEN]);
+	
+	
+	// Returns the point u1 * G + u2 * q, where the table was filled by precomputeDoubleMultiplyTable(q). This is
+	// the same as doubleMultiply(u1, G, u2, q), except that no multiples are computed: G's table of the same width is
+	// built once per process (on first use) and shared, so both halves use the wider window. The result is usually
+	// not normalized. Not constant-time, so all inputs must be public values.
+	public: static CurvePoint doubleMultiplyPrecomputed(const Uint256 &u1, const Uint256 &u2, const CurvePoint table[PRECOMPUTED_TABLE_LEN]);
+	
+	
+	// Returns the point u1 * G + u2 * q, where q must be on the curve or be zero. This is the same as
+	// doubleMultiply(u1, G, u2, q), except that the two halves of u1 use G's shared wide-window table (see
+	// doubleMultiplyPrecomputed()), so only q's width-5 table is computed. The result is usually not normalized.
+	// Not constant-time, so all inputs must be public values.
+	public: static CurvePoint doubleMultiplyGenerator(const Uint256 &u1, const Uint256 &u2, const CurvePoint &q);
+	
+	
+	// Fills the given table for multiplyGenerator(). With W = GENERATOR_TABLE_WINDOW, the entry at index
+	// i * 2^(W-1) + j - 1 is the normalized point j * 2^(i*W) * G, for each window i and 1 <= j <= 2^(W-1).
+	// The contents are the same on every platform with the same byte order. Not constant-time.
+	public: static void precomputeGeneratorTable(CurvePoint table[GENERATOR_TABLE_LEN]);
+	
+	
+	// Returns n * G using a table filled by precomputeGeneratorTable(), with one Booth digit lookup and one
+	// point addition per window and no doublings. The result is usually not normalized. Constant-time
+	// with respect to n.
+	public: static CurvePoint multiplyGenerator(const Uint256 &n, const CurvePoint table[GENERATOR_TABLE_LEN]);
+	
+	
+	// Returns n * G, using the table installed by setGeneratorTable() if there is one, otherwise multiplyGlv().
+	// The result is usually not normalized. Constant-time with respect to n.
+	public: static CurvePoint multiplyGenerator(const Uint256 &n);
+	
+	
+	// Sets the table (filled by precomputeGeneratorTable()) that multiplyGenerator(n) uses, and hence key generation
+	// and Ecdsa signing, or null to compute with multiplyGlv() instead. The table is not owned, and must
+	// outlive its installation. Thread-safe, but computations already in progress may still use the previous table.
+	// The default is no table.
+	public: static void setGeneratorTable(const CurvePoint *table);
+	
+	
+	// Computes the full 512-bit product of the given numbers, in little-endian words.
+	// Constant-time with respect to both values.
+	public: static void multiplyFull(const Uint256 &x, const Uint256 &y, std::uint32_t product[Uint256::NUM_WORDS * 2]);
+	
+	
+	// Splits the given scalar into two halves such that n = (-1)^neg1 * n1 + (-1)^neg2 * n2 * LAMBDA (mod ORDER),
+	// where n1 < 2^128 and n2 < 2^128 are magnitudes, and neg1 and neg2 are each 0 or 1. The input n is
+	// unrestricted. Constant-time with respect to the value.
+	public: static void splitScalar(const Uint256 &n, Uint256 &n1, std::uint32_t &neg1, Uint256 &n2, std::uint32_t &neg2);
+	
+	
+	// Returns the sum of scalars[i] * points[i] for 0 <= i < n, using Pippenger's bucket method. The scalars are
+	// unrestricted 256-bit values, and each point must be on the curve or be zero. The window width is chosen from
+	// n, but is reduced so that at most scratchLen buckets are needed; the caller supplies the bucket storage (see
+	// multiScalarScratchLen()), so that no memory is allocated here. Requires scratchLen >= 1 if n > 0. The result
+	// is usually not normalized. Not constant-time, so all inputs must be public values.
+	public: static CurvePoint multiScalarMultiply(const Uint256 scalars[], const CurvePoint points[], std::size_t n,
+		CurvePoint scratch[], std::size_t scratchLen);
+	
+	
+	// Returns the number of scratch points that multiScalarMultiply() uses at most for
+	// the given number of terms, when it is not constrained by the caller's scratch length.
+	public: static std::size_t multiScalarScratchLen(std::size_t n);
+	
+	
+	/*---- Private helper functions ----*/
+	
+	private: static constexpr int WNAF_MAX_LEN = Uint256::NUM_WORDS * 32 + 1;  // One extra digit for the final carry
+	private: static constexpr int DOUBLE_MULTIPLY_WINDOW = 5;
+	private: static constexpr int STRAUSS_MAX_TERMS = 4;
+	private: static constexpr int MULTI_SCALAR_MAX_WINDOW = 16;
+	
+	
+	// Adds the given point to this point, with the same result as add(). The special cases (either point
+	// being zero, or the points having the same x) are handled by branching rather than by computing both
+	// candidate results. The resulting state is usually not normalized. Not constant-time.
+	private: void addVartime(const CurvePoint &other);
+	
+	
+	// Computes the general addition formula of this point and the given point, which is only correct if neither
+	// point is zero and the x coordinates differ. If otherNormalized is true, the given point must have z = 1, and
+	// three multiplications are skipped. Sets sameX and sameY to whether the points' x and y coordinates are equal
+	// as affine values. The given point may alias this point. Constant-time with respect to both values, but not
+	// otherNormalized.
+	private: void addDistinct(const CurvePoint &other, bool otherNormalized, bool &sameX, bool &sameY);
+	
+	
+	// Returns the sum of (-1)^negs[i] * scalars[i] * tables[i][0] for 0 <= i < count, where each table holds
+	// the odd multiples tables[i][j] = (2j + 1) * tables[i][0] for 0 <= j < 2^(widths[i] - 2). The terms share
+	// one chain of doublings driven by the wNAF digits of all the scalars. Not constant-time.
+	private: static CurvePoint straussMultiply(int count, const Uint256 scalars[], const std::uint32_t negs[],
+		const CurvePoint *const tables[], const int widths[]);
+	
+	
+	// Fills table[i] = (i + 1) * p for 0 <= i < len. The entries are usually not normalized.
+	// Constant-time with respect to the point value.
+	private: static void precomputeMultiples(const CurvePoint &p, CurvePoint table[], int len);
+	
+	
+	// Returns (-1)^(flip XOR (digit < 0)) * table[abs(digit) - 1], or zero if the digit is zero, where table[i] = (i + 1) * P
+	// and -len <= digit <= len. Every table entry is read with vectorized masking where available, using unaligned loads
+	// so the table needs no particular alignment. Constant-time with respect to the table values, digit, and flip.
+	private: static CurvePoint selectSigned(const CurvePoint table[], int len, int digit, std::uint32_t flip);
+	
+	
+	// Fills table[i] = (2i + 1) * p for 0 <= i < len. The entries are usually not normalized. Not constant-time.
+	private: static void precomputeOddMultiples(const CurvePoint &p, CurvePoint table[], int len);
+	
+	
+	// Replaces each point in the given table by its image under the endomorphism, (x, y, z) -> (BETA * x, y, z),
+	// which equals LAMBDA times the point. Constant-time with respect to the values.
+	private: static void applyEndomorphism(CurvePoint table[], int len);
+	
+	
+	// Multiplies the given number by the curve parameter B = 7. Constant-time with respect to the value.
+	private: static void multiplyByB(FieldInt &val);
+	
+	
+	// Computes the width-w non-adjacent form of n, such that n = sum(naf[i] * 2^i) and each nonzero digit
+	// is odd and in the range (-2^(w-1), 2^(w-1)). Every element of naf is written. Returns the number of
+	// digits up to and including the most significant nonzero one (0 if n is zero). Not constant-time.
+	private: static int computeWnaf(const Uint256 &n, int width, std::int8_t naf[WNAF_MAX_LEN]);
+	
+	
+	// Returns the Booth-recoded (signed) digit of n at the given bit position, in the range [-2^(width-1), 2^(width-1)].
+	// Summing digit(i * width) * 2^(i * width) over 0 <= i < ceil(257 / width) yields n exactly. Bits outside of n
+	// are taken as zero. Constant-time with respect to the value of n, but not the position or width.
+	private: static int getBoothDigit(const Uint256 &n, int pos, int width);
+	
+	
+	// Returns the table that precomputeDoubleMultiplyTable(G) fills, computing it on the first call. Thread-safe.
+	private: static const CurvePoint *getGeneratorDoubleMultiplyTable();
+	
+	
+	// Returns the bucket window width for multiScalarMultiply() with n terms and at most scratchLen buckets.
+	private: static int getMultiScalarWindow(std::size_t n, std::size_t scratchLen);
+	
+	
+	
 	/*---- Class constants ----*/
 	
 	public: static const FieldInt FI_ZERO;  // These FieldInt constants are declared here because they are only needed in this class,
@@ -125,5 +339,18 @@ class CurvePoint final {
 	public: static const Uint256 ORDER;    // Order of base point, which is a prime number
 	public: static const CurvePoint G;     // Base point (normalized)
 	public: static const CurvePoint ZERO;  // Dummy point at infinity (normalized)
+	public: static const FieldInt BETA;    // Cube root of unity modulo the field prime, such that (BETA * x, y) = LAMBDA * (x, y)
+	public: static const Uint256 LAMBDA;   // Cube root of unity modulo ORDER
+	
+	// Reduced lattice basis {(A1, -MINUS_B1), (A2, B2)} of the endomorphism's kernel, and the rounded
+	// quotients G1 = round(2^384 * B2 / ORDER) and G2 = round(2^384 * MINUS_B1 / ORDER), used in splitScalar()
+	private: static const Uint256 GLV_A1;
+	private: static const Uint256 GLV_MINUS_B1;
+	private: static const Uint256 GLV_A2;
+	private: static const Uint256 GLV_B2;
+	private: static const Uint256 GLV_G1;
+	private: static const Uint256 GLV_G2;
+	
+	private: static std::atomic<const CurvePoint *> generatorTable;  // Null or GENERATOR_TABLE_LEN entries
 	
 };
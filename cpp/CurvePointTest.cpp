@@ -15,6 +15,9 @@
 #include "FieldInt.hpp"
 #include "Uint256.hpp"
 
+using std::uint8_t;
+using std::uint32_t;
+
 
 /*---- Structures ----*/
 
@@ -348,14 +351,148 @@ static void testMultiply() {
 		{"7BCBA36D1148C7A5AC938CA14C19A947E69F230577C182E243EEA7539E5C544B", "7B5D4B743D6FA328DBE32D49C276B123C04887AEAEC01F117582E846F6F2255A", "35C32C24B0499A3968CBD609A32EB3627EA99A5798BF50BE8B28608BDBE5FACB"},
 		{"59B5E4509B28E1EA788C777C73337E4DC4F465C8772DAD204C8EE5FAFE2D4645", "51471C106EE9BC9E4D46ACF6409FA3C13787835080B2FE921BB2CCF9699636A9", "8272B678EB7E805A0725BC709E2BB2AEA7F10F3A53DAE3512D6DC8EEBF1D137B"},
 	};
+	vector<CurvePoint> genTable(CurvePoint::GENERATOR_TABLE_LEN, CurvePoint::ZERO);
+	CurvePoint::precomputeGeneratorTable(genTable.data());
 	for (const ThreeStrings &tc : cases) {
+		const Uint256 n(tc.a);
 		CurvePoint p = CurvePoint::G;
-		p.multiply(Uint256(tc.a));
+		p.multiply(n);
 		p.normalize();
+		CurvePoint q = CurvePoint::G;
+		q.multiplyGlv(n);
+		q.normalize();
 		if (tc.b == nullptr && tc.c == nullptr)
-			assert(p == CurvePoint::ZERO);
+			assert(p == CurvePoint::ZERO && q == CurvePoint::ZERO);
 		else
-			assert(p == CurvePoint(tc.b, tc.c));
+			assert(p == CurvePoint(tc.b, tc.c) && q == p);
+		assert(CurvePoint::multiplyGenerator(n, genTable.data()) == p);
+		
+		// x-only ladder, from normalized and unnormalized inputs
+		FieldInt x = CurvePoint::FI_ONE;
+		assert(CurvePoint::G.multiplyX(n, x) == (tc.b != nullptr));
+		assert(x == (tc.b != nullptr ? FieldInt(tc.b) : CurvePoint::FI_ZERO));
+		CurvePoint g3 = CurvePoint::G;
+		g3.twice();
+		g3.add(CurvePoint::G);  // Unnormalized 3G
+		CurvePoint r = g3;
+		r.multiply(n);
+		r.normalize();
+		assert(g3.multiplyX(n, x) == !r.isZero() && x == r.x);
+		
+		// Other window widths
+		CurvePoint others[] = {CurvePoint::G, CurvePoint::G, CurvePoint::G, CurvePoint::G};
+		others[0].multiply<1>(n);
+		others[1].multiply<3>(n);
+		others[2].multiply<5>(n);
+		others[3].multiply<8>(n);
+		for (CurvePoint &r : others) {
+			r.normalize();
+			assert(r == p);
+		}
+		numTestCases++;
+	}
+}
+
+
+static void testMultiplyGlv() {
+	// The endomorphism on the base point
+	{
+		CurvePoint p = CurvePoint::G;
+		p.multiply(CurvePoint::LAMBDA);
+		p.normalize();
+		FieldInt x = CurvePoint::G.x;
+		x.multiply(CurvePoint::BETA);
+		assert(p == CurvePoint(x, CurvePoint::G.y));
+		numTestCases++;
+	}
+	
+	// Zero times anything
+	{
+		CurvePoint p = CurvePoint::ZERO;
+		p.multiplyGlv(Uint256("45528A55356F7C32CA753F1E58627BC33863670A1072D9C8DD0663EB5691D87F"));
+		p.normalize();
+		assert(p == CurvePoint::ZERO);
+		numTestCases++;
+	}
+	
+	// Compare with the plain method on points other than the base point
+	const vector<TwoStrings> cases{
+		{"0000000000000000000000000000000000000000000000000000000000000003", "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364140"},
+		{"11D6DD13D560E703C7F0189140DF2F692B603EF57A5E10E29C3E163ACD1E8FF8", "E1E1DD6FBA9D293B4F5F46BE5A3F05A7BCE9CDBD8993BC0282DCF6B975D285F1"},
+		{"3CBD5DE8E80196F3F5DB4D925A29638E4BFE4A9A848A9424BAD5C46136837C1F", "5363AD4CC05C30E0A5261C028812645A122E22EA20816678DF02967C1B23BD72"},
+		{"EFA4125849134857FBC1A97675A43B5DE6C1D268E2CA7AB1E179DB25F13DE00C", "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF"},
+		{"B177E15F7CF844C240A7749F332DF50A692A372D6AFFD786629686540C8E73F2", "0000000000000000000000000000000100000000000000000000000000000000"},
+		{"9806E0E601FDE9777CFBA9BE56FE90453023E6B08F5BE6CB18555156DE3AB5C3", "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364141"},
+	};
+	for (const TwoStrings &tc : cases) {
+		CurvePoint p = CurvePoint::G;
+		p.multiply(Uint256(tc.a));
+		p.normalize();
+		CurvePoint q = p;
+		CurvePoint r = p;
+		q.multiply(Uint256(tc.b));
+		q.normalize();
+		r.multiplyGlv(Uint256(tc.b));
+		r.normalize();
+		assert(q == r);
+		numTestCases++;
+	}
+}
+
+
+static void testMultiplyX() {
+	// Diffie-Hellman agreement
+	const Uint256 a("3C6DD2FB71D6E42EA25FDD4F7A5F0E5A81E8BB0C95B36F6AA6E6A2B1F8D0C5E1");
+	const Uint256 b("E9873D79C6D87DC0FB6A5778633389F4453213303DA61F20BD67FC233AA33262");
+	CurvePoint pa = CurvePoint::privateExponentToPublicPoint(a);
+	CurvePoint pb = CurvePoint::privateExponentToPublicPoint(b);
+	FieldInt xa = CurvePoint::FI_ZERO;
+	FieldInt xb = CurvePoint::FI_ZERO;
+	assert(pb.multiplyX(a, xa) && pa.multiplyX(b, xb) && xa == xb);
+	numTestCases++;
+	
+	// Zero input
+	FieldInt x = CurvePoint::FI_ONE;
+	assert(!CurvePoint::ZERO.multiplyX(a, x) && x == CurvePoint::FI_ZERO);
+	numTestCases++;
+}
+
+
+static void testSplitScalar() {
+	struct SplitCase {
+		const char *n;
+		const char *n1;
+		uint32_t neg1;
+		const char *n2;
+		uint32_t neg2;
+	};
+	const vector<SplitCase> cases{
+		{"0000000000000000000000000000000000000000000000000000000000000000", "0000000000000000000000000000000000000000000000000000000000000000", 0, "0000000000000000000000000000000000000000000000000000000000000000", 0},
+		{"0000000000000000000000000000000000000000000000000000000000000001", "0000000000000000000000000000000000000000000000000000000000000001", 0, "0000000000000000000000000000000000000000000000000000000000000000", 0},
+		{"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364140", "0000000000000000000000000000000000000000000000000000000000000001", 1, "0000000000000000000000000000000000000000000000000000000000000000", 0},
+		{"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364141", "0000000000000000000000000000000000000000000000000000000000000000", 0, "0000000000000000000000000000000000000000000000000000000000000000", 0},
+		{"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364142", "0000000000000000000000000000000000000000000000000000000000000001", 0, "0000000000000000000000000000000000000000000000000000000000000000", 0},
+		{"5363AD4CC05C30E0A5261C028812645A122E22EA20816678DF02967C1B23BD72", "0000000000000000000000000000000000000000000000000000000000000000", 0, "0000000000000000000000000000000000000000000000000000000000000001", 0},
+		{"AC9C52B33FA3CF1F5AD9E3FD77ED9BA4A880B9FC8EC739C2E0CFC810B51283CF", "0000000000000000000000000000000000000000000000000000000000000000", 0, "0000000000000000000000000000000000000000000000000000000000000001", 1},
+		{"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF", "000000000000000000000000000000003086D221A7D46BCDE86C90E59284EEE6", 0, "000000000000000000000000000000003086D221A7D46BCDE86C90E49284EB15", 1},
+		{"0000000000000000000000000000000100000000000000000000000000000000", "0000000000000000000000000000000014CA50F7A8E2F3F657C1108D9D44CFD8", 1, "000000000000000000000000000000003086D221A7D46BCDE86C90E49284EB15", 1},
+		{"7FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF5D576E7357A4501DDFE92F46681B20A0", "00000000000000000000000000000000A2A8918CA85BAFE22016D0B917E4DD76", 0, "0000000000000000000000000000000059DE565A2C9D0E2D4373F7623C1D7CD7", 1},
+		{"AC9C52B33FA3CF1F5AD9E3FD77ED9BA4A880B9FC8EC739C2E0CFC810B51283CE", "0000000000000000000000000000000000000000000000000000000000000001", 1, "0000000000000000000000000000000000000000000000000000000000000001", 1},
+		{"12EE52D2324779614935B675F501084146F7C9EAB38CF45A7AD98A70A603E9E1", "0000000000000000000000000000000090361B38AA979D4C50F990C6A1484933", 0, "0000000000000000000000000000000044C2C61B43EF4580DB55ED440588C2B1", 1},
+		{"D58AF9595F53F30140BEE3855543DB2B8A20D9BFD30288E74120AC1510BC09C5", "000000000000000000000000000000001B0608E0056F0E8D3153652C6942A260", 0, "0000000000000000000000000000000024F12A1A500BE92E156205F36A522CC7", 1},
+		{"D24375777DBD48A33D657B91E8E0E2373F725D532EEF070E672490E5D09B0BF1", "000000000000000000000000000000005571CBF8DEEA2D1554B37541664F0A44", 1, "0000000000000000000000000000000081F5B39D2D567D8F9B88C139C0582817", 1},
+		{"9C5D1EDB1427C9D4A77BF53192B007DAA3377235EAF5C04FBAD02341124327D2", "00000000000000000000000000000000892AF2989B0E807144420DD098118C86", 0, "000000000000000000000000000000002092880980391BFF0893A6A7D4F9356F", 1},
+		{"7081EA97A853C4BB0D7E8A95BD7BBC076AFBEF4FC65A478B6CDAC39DD6AD2467", "000000000000000000000000000000001F10A8C3259A0CDA8BC573ADCAE6394D", 1, "0000000000000000000000000000000076F2100C285A63F7DB9C9CE53CEB7847", 1},
+		{"7A7FAEBBA48B2364D0E93B1DF9744FC0D85311B3031937A85986A700FE21EE08", "000000000000000000000000000000006E50253051D83C4A4546B7CE2DBA0C34", 1, "00000000000000000000000000000000663819BA42FEFA72FAEF923490E7D857", 1},
+		{"3A3B91C1A67AFF4E9C2A5DA1567C2D5FF0B169D09CC920F623350F9240C09B9F", "0000000000000000000000000000000021F76B274C553437977CF5D7FB1F9C3B", 0, "000000000000000000000000000000003168A4270EB21DD2E7C9A0C3DF19914C", 0},
+		{"C07F840764563CFDF9C84F801946EAAF2416B27086342D4AD0842B04B4498921", "00000000000000000000000000000000392FEB92639085A988719B425BEE16A3", 1, "000000000000000000000000000000005C5530A3B936193C6A17ABC45C362582", 1},
+		{"AE09A42DC691369F099E82E5EE64E1DCCBBB3962BFD96797E950BAE64D523A59", "000000000000000000000000000000004FDC6A1EC3C2AFE44D9B22E46DDFF1F7", 1, "0000000000000000000000000000000040A71D3A919EF23C0C8811B19CFE0403", 1},
+	};
+	for (const SplitCase &tc : cases) {
+		Uint256 n1, n2;
+		uint32_t neg1, neg2;
+		CurvePoint::splitScalar(Uint256(tc.n), n1, neg1, n2, neg2);
+		assert(n1 == Uint256(tc.n1) && neg1 == tc.neg1 && n2 == Uint256(tc.n2) && neg2 == tc.neg2);
 		numTestCases++;
 	}
 }
@@ -499,6 +636,121 @@ static void testMultiplyModOrder() {
 }
 
 
+static void testDoubleMultiply() {
+	const vector<SixStrings> cases{
+		// u1, u2, q.x, q.y, (u1 * G + u2 * q).x, (u1 * G + u2 * q).y
+		{"0000000000000000000000000000000000000000000000000000000000000000", "0000000000000000000000000000000000000000000000000000000000000000", "79BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798", "483ADA7726A3C4655DA4FBFC0E1108A8FD17B448A68554199C47D08FFB10D4B8", nullptr, nullptr},
+		{"0000000000000000000000000000000000000000000000000000000000000001", "0000000000000000000000000000000000000000000000000000000000000000", "79BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798", "483ADA7726A3C4655DA4FBFC0E1108A8FD17B448A68554199C47D08FFB10D4B8", "79BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798", "483ADA7726A3C4655DA4FBFC0E1108A8FD17B448A68554199C47D08FFB10D4B8"},
+		{"0000000000000000000000000000000000000000000000000000000000000000", "0000000000000000000000000000000000000000000000000000000000000001", "5CBDF0646E5DB4EAA398F365F2EA7A0E3D419B7E0330E39CE92BDDEDCAC4F9BC", "6AEBCA40BA255960A3178D6D861A54DBA813D0B813FDE7B5A5082628087264DA", "5CBDF0646E5DB4EAA398F365F2EA7A0E3D419B7E0330E39CE92BDDEDCAC4F9BC", "6AEBCA40BA255960A3178D6D861A54DBA813D0B813FDE7B5A5082628087264DA"},
+		{"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364140", "0000000000000000000000000000000000000000000000000000000000000001", "79BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798", "483ADA7726A3C4655DA4FBFC0E1108A8FD17B448A68554199C47D08FFB10D4B8", nullptr, nullptr},
+		{"0000000000000000000000000000000000000000000000000000000000000002", "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD036413F", "79BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798", "483ADA7726A3C4655DA4FBFC0E1108A8FD17B448A68554199C47D08FFB10D4B8", nullptr, nullptr},
+		{"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364146", "0000000000000000000000000000000000000000000000000000000000000003", "ACD484E2F0C7F65309AD178A9F559ABDE09796974C57E714C35F110DFC27CCBE", "CC338921B0A7D9FD64380971763B61E9ADD888A4375F8E0F05CC262AC64F9C37", "D30199D74FB5A22D47B6E054E2F378CEDACFFCB89904A61D75D0DBD407143E65", "95038D9D0AE3D5C3B3D6DEC9E98380651F760CC364ED819605B3FF1F24106AB9"},
+		{"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF", "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF", "C6047F9441ED7D6D3045406E95C07CD85C778E4B8CEF3CA7ABAC09B95C709EE5", "1AE168FEA63DC339A3C58419466CEAEEF7F632653266D0E1236431A950CFE52A", "771ED3A235058F341B475F6344A59BF024CBB6F901D82593929994322395ADD3", "90A157FD2A41FF10DEC47D459B1A15404E7EE1F859E201C3E826B1996022D93C"},
+		{"0000000000000000000000000000000000000000000000000000000000000005", "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD036413C", "79BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798", "483ADA7726A3C4655DA4FBFC0E1108A8FD17B448A68554199C47D08FFB10D4B8", nullptr, nullptr},
+		{"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364140", "FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364140", "79BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798", "B7C52588D95C3B9AA25B0403F1EEF75702E84BB7597AABE663B82F6F04EF2777", nullptr, nullptr},
+		{"8B4486C599CB381B6EB58EEA34854702A8D4293433E798A0E81F9B0CBF4E7AF6", "BAEC80760AAF3A947A2D4F33C3B072E1F37FE7B9C6BD788120BC3FD70E87A553", "8426A5374272F5F04E3D9A908BC5557A7D0FADE1F035B47121CA71BB184312D9", "B895E4331EDDB0E15EEC816B45751C01988247CE9E3F8DF4BFE995A74C3A5449", "70006DDEF4D94DDABBF854AA600F8A02A7556856B0EFCBA48637D323306EF2E0", "EEACE63A0EA9B7E97D90CCDCD07AB13743CA71A3B46E7B45BE5CB020C2700FA5"},
+		{"B1479939C94B3F4A33B29589D819C90FB79BCD2368BD7159BF6BBB58FC9C2429", "24EA816A38E7741BDAAE3BEAF019DAEEAAAA3BC8075EE326DB1E799DF8C4EFB3", "11EAEBADE35C817DA0D382E077ABFD35F03185C22C69B59F68D76926C2979FB1", "FBFE7D3A2141CE2FA2134EFB31C93D3ABC2024EB2F3D0FA613D40595AB9D1B81", "D0D050AA96067CD5E4AAC9B281A0F0D4CE3E2F7BF0C393323E9A306F0E661D85", "8F6043794BCE796CC857C4BECC973A409406C4E871B4402945C2BB1115E27A7D"},
+		{"BCAD1974F7F003EE07C7259207E1E5A8958AD302D3E374B53E5F8D205D415F26", "A4F691640B384BA6826E86EA1FD486AF8964B4818B235CB4D83C64A04B202F42", "BEB79B3F9D1233D7F4BED8EA31626AF6C312F8EDD9D26BDD95A223FE3CABD21B", "0CB434EAA7B65AAFD48C05ED0ADDCFB9C4BCCE3342FC05450ECA3204E25C54D2", "5AEAE6378F6BC25F91529793F336655B1F8D22B9594E005D0DEF449CE68C2570", "F0F9CE2B20CC2D8EE67320CB06983FDD30326CDC01BD237DD0B7EF45184A04C4"},
+		{"0E635A193363254DB16D7BF1D8EB6C8A6E984DE36C676BF5AA84DAACD9E44C7A", "DDEDE5F4626207159FCD964AF0939A0B32873E8140239DB3F37382CCE181F9E5", "5168B41004201B00615C0CB9910FFE87FDDE7F2DDA6E337E9CD8FCA7A619E1FF", "6F7CA8ED529C5DD243B5A7487C91A9EE2A0AC92A780C72E74D5362F11FA449C6", "3F2A7E4516241588BA9C96991885220095954A47F9457F31B57B6FAFE1133C4A", "8914611C7661291877DE715AC615D1CA33C81A5602B285D477CA89C587B2D0C4"},
+		{"37D1B3A46820D71C0C08E4B40B74A7CEC77705E0B6CEBF938C74A05B8B81086D", "DAB653C81730C9F8E9C536B1FD8D46C5FDC0781DC7F9BE44989E7D805EB63A34", "DD287B3E91DF32101AB97CF8AB4736A065819EC3529D4BF5C18527BFB190BDBF", "DA8E792A2E2E1A9BD973CA1CB357DFCB9B4D935F8FBAC0E6531D03BF62687E60", "BE4A03AC9221864C06DE85A13CFB71D3C5DF5C0AE2C0590D58D3169BA438EBDA", "132A586C7B14E2161544EB55AE6F7F6BDA8060806DEF835463B034484F5601D2"},
+		{"ACEB2AAA18A4B0D25A2F92C70A5FC8151328111194DFE77475168E5EB4DB8E74", "46C69697F59592E3ADC0643C223FC545F60F466014ECA798CB14E3E43D5B5B26", "E2D3575C7349943EFAF75C5AB0E51896A4CB983F2A5DA67051175B568A7377C2", "71B2372A27255AA311E8A51E93A4C88EA7C136E762680CD44598B89C8E17EAB8", "348401BEA568508729C083352D03DA04BAB380FD04F988370760237D51B28321", "3A6DC2C6386CBB24DB8B0B0FAF0C3EFB4A7EAB9E94B00A16F02A25C398EC14DE"},
+		{"9A615BB8783C5853856F3E9458FF5DA26FAE5523B2AA4460AE93BAD2E9B11F69", "02165D6F914DD15226E559740B49560AF76C245008448799B604135363DBB78A", "6A39F3F2E8A158B1F52FBBFF2AFA7D7C7878E85F3576709F2103C17272606875", "0A867FCC10A30AA7645CED3F3C2BED5FB8954AAB80F16011C363CD797E6A69A1", "2FDF7BF6D1F8F704E4EC92E2CE417F7D3B45CDBAF5F21F7A635383DF1BE90738", "30D054C0ED59F90E6F43C41751008343BDFF6414EE4177984FC5323FAD75E0E4"},
+		{"B1D97BDA08B8E15A9C65D156D0C7B32E2EDB61AC94FEF0D508843DFA79FC596B", "29F400096D978FA0F8F6E4A14ACDBE3F0C7755836DFBAF7FCEDD584504E701C8", "02D2E7F6DFBCCE9D387C550D872D904F243BC78FC2E041B02484F2B1CF823B13", "69720EE60589D5A179B4EE313F912E955DA45B2D8B3B7DD5E00FC892288DF1CE", "120E53D394F02B03E096AA406520E53FF7BEB12C38F9C677225CB2B6C0687E31", "0A460E6B548F9D6643B99DF0D2A7DAB67337A55BA2E0EE027CF9CBC3EE71DECD"},
+		{"8BAD1C356C5CDEFAEB322C8CAE4287A0D830AF2005403A5DE1465E7F08753A97", "5257DF30EFE492B2D1C048037D97BAA346D4766AF0BFA6FECE3DD93E05D3C445", "6500EA277F9486E47806BC87A593977C606F2EF61A23D47C423A4AD7A093CFC3", "90BAF27F1521A7C847C58DC58241B792F975B587333887A13B0F94907A0B60E1", "24E61AAB6AB9DF342AF8E86F4FBE952FCB0E5782A4D494B9FF2C2AB8DBFB504A", "7B93DEDDD08933C372D845A9F88CB42D690D358CAAD0B132F8E640E7A68A9BCF"},
+		{"D69B2335253E6D303BFF589D4E5E74D13CE5C7A6708CBCDA34F6AD26F73F24A9", "50F9A2C1CE9BA3EC9F9CBC3966DECE8C62C7F4A4FBB5511B800AE22F98855311", "991519052A5F16CBB6737F73EED4953AF550FC0E84A9BECE4BDB1DD0251FD07F", "5F429ACF7459CAA92E8601A50AEEE32B43F20C77846B67466190561F41C8D299", "7C8F31E96E4390D18BC5608047ED8FF35D2BB2D1B8D9400759591F66B8FFF55F", "D19AB25E28FB520A12E9CCBFB498BBA9AADD45C8B400B89192B255AC8889C959"},
+		{"000000000000000000000000000000000610FC520B4C08CFB0540F5BEDA774FC", "52E7B46547F85408334FD56E1139834052CD07593E0ABD7365A7AB0624D291B9", "BE7A6A247F54C482533525FED1F36F0E1FAE96E0113DEFF905816AE12FE740C4", "690F030188FF0D3DCAD276696E0D4EAFD930AD66001495EAEB348E45A30534ED", "0AEFDCD6F560DFB9F1657FCDEA6929F47F7B21A50BED004EA6A2A36094592850", "2967AD0C34EA6784E08DC49FB571DA5F1A03ECBCB579D3C1D77F897B3B36A29B"},
+		{"363DE98F368B084905F2267E1A8671DD19AB090DB6ED7405F99E22C1E9F7D85A", "00000000000000000000000000000000000000000000000000000000000C1F2C", "42ADF43923839B487D9E55D25C8E951932058BC102BDA9AEC48984F5A449472C", "108C337916A3BE0B7EAC2D888BEF05BF2F79FCC0A9E4DFA91EE8CDC4E9A09C88", "B13C8C5288F957249A745C8D05933DA7D751FC8638A1BC9AEFD5FA66C05692E8", "A2217C206B09BEB73077956C6F7F04D8659DE31B630D17B4B27F94EFEE682D02"},
+	};
+	for (const SixStrings &tc : cases) {
+		const Uint256 u1(tc.a);
+		const Uint256 u2(tc.b);
+		const CurvePoint q(tc.c, tc.d);
+		CurvePoint p = CurvePoint::doubleMultiply(u1, CurvePoint::G, u2, q);
+		p.normalize();
+		if (tc.e == nullptr && tc.f == nullptr)
+			assert(p == CurvePoint::ZERO);
+		else
+			assert(p == CurvePoint(tc.e, tc.f));
+		assert(CurvePoint::doubleMultiplyGenerator(u1, u2, q) == p);  // Projective comparison
+		
+		// Compare with two separate multiplications
+		CurvePoint r = CurvePoint::G;
+		CurvePoint s = q;
+		r.multiply(u1);
+		s.multiply(u2);
+		r.add(s);
+		r.normalize();
+		assert(p == r);
+		numTestCases++;
+	}
+}
+
+
+static void testMultiScalarMultiply() {
+	const vector<ThreeStrings> cases{  // Scalar, point x, point y
+		{"39F5C88E2D94628BB64BA4FD98E616EC8BB01460217F871CBE0AE8FA1CEAC2CC", "D7A4BBD9968E179B80B4A3CE2270DD6952C285AE5F110B425759FB1B2AC66115", "2EFC0310A37CBB06DB131056C9517EED5FD8A45A2FA98082B5640A1A9AEF9EE1"},
+		{"24F1E3CD369CBD3F35FEF5876AE5BC08C37F0CE876CF29A6A34FAAB921EB4E08", "FE2BBA1FABCB361D5A26A87447911B514F297300A2DE07A85D0679DDF486CEDE", "63B196B3CA25CF25937385CD4B10F38A1B62682527D66D32916FE70557141A72"},
+		{"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF", "3499D5E480DFA8432A1EA5352401AEAE889CC1ADB57A660F87A2AC5DC39BE128", "9EA892B0F8F99773BB62488C5E7C78F77008B6D7358AB615A54EF1E642EE5543"},
+		{"E5DB963BFC17EBBE6B9EE2B31850F2AB11CDA0B83D693DA968311DE3071DAA8C", "FE2BBA1FABCB361D5A26A87447911B514F297300A2DE07A85D0679DDF486CEDE", "63B196B3CA25CF25937385CD4B10F38A1B62682527D66D32916FE70557141A72"},
+		{"EED09383E76C8BE02D27F3132122DEC3D34787E4FD2FC982B24FA0D25086AFAB", "533D79FAC76B58A00E38DD6571ED4EE27ECB8F09B39D66C744DC614D422CC7A8", "3AC0F220F505A86CEA3970EB2D993140DBBFD9C58D23AF74B29B56FD5571F7B9"},
+	};
+	vector<Uint256> scalars;
+	vector<CurvePoint> points;
+	for (const ThreeStrings &tc : cases) {
+		scalars.push_back(Uint256(tc.a));
+		points.push_back(CurvePoint(tc.b, tc.c));
+	}
+	const CurvePoint expect("AD1324192C99C455295A908C6508F3236EC71679551420673D5BAFC069DF9715", "6DC35BDBDBA552AF785788B5CFEECE8F66F9C03A37FDF682348DFD642458BCEA");
+	vector<CurvePoint> scratch(CurvePoint::multiScalarScratchLen(scalars.size()), CurvePoint::G);
+	CurvePoint p = CurvePoint::multiScalarMultiply(scalars.data(), points.data(), scalars.size(), scratch.data(), scratch.size());
+	p.normalize();
+	assert(p == expect);
+	numTestCases++;
+	
+	// Compare with separate multiplications, over various lengths and scratch sizes
+	std::uint64_t seed = 1;
+	for (std::size_t n = 0; n < 48; n += 1 + n / 4) {
+		scalars.clear();
+		points.clear();
+		CurvePoint sum = CurvePoint::ZERO;
+		for (std::size_t i = 0; i < n; i++) {
+			Uint256 k;
+			for (int j = 0; j < Uint256::NUM_WORDS; j++) {
+				seed = seed * UINT64_C(6364136223846793005) + UINT64_C(1442695040888963407);
+				k.value[j] = static_cast<uint32_t>(seed >> 32);
+			}
+			if (i % 7 == 3)
+				k = Uint256::ZERO;
+			else if (i % 7 == 5)
+				k = CurvePoint::ORDER;
+			Uint256 m;
+			m.value[0] = static_cast<uint32_t>(i * i + 1);
+			CurvePoint q = CurvePoint::G;
+			q.multiply(m);
+			if (i % 5 == 4) {  // Repeat an earlier point, negated
+				q = points[i - 2];
+				q.negate();
+			}
+			scalars.push_back(k);
+			points.push_back(q);
+			q.multiply(k);
+			sum.add(q);
+		}
+		sum.normalize();
+		
+		for (std::size_t scratchLen = 1; ; scratchLen *= 4) {
+			scratch.assign(scratchLen, CurvePoint::ZERO);
+			CurvePoint p = CurvePoint::multiScalarMultiply(scalars.data(), points.data(), n, scratch.data(), scratchLen);
+			p.normalize();
+			assert(p == sum);
+			numTestCases++;
+			if (scratchLen >= CurvePoint::multiScalarScratchLen(n))
+				break;
+		}
+	}
+}
+
+
 static void testIsOnCurve() {
 	const vector<ThreeStrings> cases{
 		// High and low multiples of the base point
@@ -1098,6 +1350,151 @@ static void testIsOnCurve() {
 }
 
 
+static void testEquality() {
+	CurvePoint a = CurvePoint::G;
+	a.twice();
+	CurvePoint negG = CurvePoint::G;
+	negG.negate();
+	CurvePoint b = a;
+	b.add(CurvePoint::G);
+	b.add(negG);  // Same point, different projective representation
+	assert(a.z != b.z && a == b && !(a != b));
+	CurvePoint c = a;
+	c.normalize();
+	assert(a == c && c == b);
+	numTestCases++;
+	
+	CurvePoint d = a;
+	d.negate();
+	assert(a != d && a != CurvePoint::G && a != CurvePoint::ZERO && CurvePoint::ZERO != a);
+	numTestCases++;
+	
+	CurvePoint e = d;
+	e.add(a);  // Zero in some representation
+	assert(e == CurvePoint::ZERO && CurvePoint::ZERO == CurvePoint::ZERO);
+	numTestCases++;
+}
+
+
+static void testHasXModOrder() {
+	// Ordinary points, unnormalized
+	CurvePoint p = CurvePoint::G;
+	for (int i = 0; i < 10; i++) {
+		p.twice();
+		p.add(CurvePoint::G);
+		CurvePoint q = p;
+		q.normalize();
+		Uint256 r(q.x);
+		r.subtract(CurvePoint::ORDER, static_cast<uint32_t>(r >= CurvePoint::ORDER));
+		assert(p.hasXModOrder(r));
+		r.add(Uint256::ONE);
+		r.subtract(CurvePoint::ORDER, static_cast<uint32_t>(r >= CurvePoint::ORDER));
+		assert(!p.hasXModOrder(r));
+		numTestCases++;
+	}
+	assert(!CurvePoint::ZERO.hasXModOrder(Uint256::ZERO));
+	numTestCases++;
+	
+	// A point whose x coordinate is at least ORDER, so that x = r + ORDER
+	const CurvePoint x2("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364143", "36B1AA62EB77C1973025CBCBEA9740EED8EACDAB8772268B395064453269D1D3");
+	CurvePoint unnorm = x2;
+	unnorm.twice();
+	unnorm.add(x2);
+	unnorm.add(x2);
+	CurvePoint minus3 = x2;
+	minus3.twice();
+	minus3.add(x2);
+	minus3.negate();
+	unnorm.add(minus3);  // Equals x2 again, with z != 1
+	assert(x2.isOnCurve() && unnorm == x2 && unnorm.z != CurvePoint::FI_ONE);
+	const Uint256 two("0000000000000000000000000000000000000000000000000000000000000002");
+	assert(x2.hasXModOrder(two) && unnorm.hasXModOrder(two));
+	assert(!x2.hasXModOrder(Uint256::ONE) && !unnorm.hasXModOrder(Uint256::ONE));
+	numTestCases++;
+}
+
+
+static void testFromBytes() {
+	const vector<ThreeStrings> cases{  // Encoding, x, y (null if invalid)
+		{"0279BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798", "79BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798", "483ADA7726A3C4655DA4FBFC0E1108A8FD17B448A68554199C47D08FFB10D4B8"},
+		{"0479BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798483ADA7726A3C4655DA4FBFC0E1108A8FD17B448A68554199C47D08FFB10D4B8", "79BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798", "483ADA7726A3C4655DA4FBFC0E1108A8FD17B448A68554199C47D08FFB10D4B8"},
+		{"0679BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798483ADA7726A3C4655DA4FBFC0E1108A8FD17B448A68554199C47D08FFB10D4B8", "79BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798", "483ADA7726A3C4655DA4FBFC0E1108A8FD17B448A68554199C47D08FFB10D4B8"},
+		{"03B169E6DBBB258118800ACA302E9CD6945165E6252FFC3F9CCA5CE4A9BDE4B664", "B169E6DBBB258118800ACA302E9CD6945165E6252FFC3F9CCA5CE4A9BDE4B664", "26A480EBFA8AB3D694E1FF27F164763079ACE3785017E75A7D2911FDCD2EAB21"},
+		{"04B169E6DBBB258118800ACA302E9CD6945165E6252FFC3F9CCA5CE4A9BDE4B66426A480EBFA8AB3D694E1FF27F164763079ACE3785017E75A7D2911FDCD2EAB21", "B169E6DBBB258118800ACA302E9CD6945165E6252FFC3F9CCA5CE4A9BDE4B664", "26A480EBFA8AB3D694E1FF27F164763079ACE3785017E75A7D2911FDCD2EAB21"},
+		{"07B169E6DBBB258118800ACA302E9CD6945165E6252FFC3F9CCA5CE4A9BDE4B66426A480EBFA8AB3D694E1FF27F164763079ACE3785017E75A7D2911FDCD2EAB21", "B169E6DBBB258118800ACA302E9CD6945165E6252FFC3F9CCA5CE4A9BDE4B664", "26A480EBFA8AB3D694E1FF27F164763079ACE3785017E75A7D2911FDCD2EAB21"},
+		{"03A7071183331AB75AC00E1F742BB4B48C7AB2536E2EF6020422E89297A1D9B612", "A7071183331AB75AC00E1F742BB4B48C7AB2536E2EF6020422E89297A1D9B612", "1ABF9AC8A97CB19EB279FBB9EC77F965F87473B5D6E42CBBBC3357DF8ACEE86F"},
+		{"04A7071183331AB75AC00E1F742BB4B48C7AB2536E2EF6020422E89297A1D9B6121ABF9AC8A97CB19EB279FBB9EC77F965F87473B5D6E42CBBBC3357DF8ACEE86F", "A7071183331AB75AC00E1F742BB4B48C7AB2536E2EF6020422E89297A1D9B612", "1ABF9AC8A97CB19EB279FBB9EC77F965F87473B5D6E42CBBBC3357DF8ACEE86F"},
+		{"07A7071183331AB75AC00E1F742BB4B48C7AB2536E2EF6020422E89297A1D9B6121ABF9AC8A97CB19EB279FBB9EC77F965F87473B5D6E42CBBBC3357DF8ACEE86F", "A7071183331AB75AC00E1F742BB4B48C7AB2536E2EF6020422E89297A1D9B612", "1ABF9AC8A97CB19EB279FBB9EC77F965F87473B5D6E42CBBBC3357DF8ACEE86F"},
+		{"036B7BF47F18B2889F91B8B0BD580998763A9A3525AE27CC1FEC6EDBCC2C54D552", "6B7BF47F18B2889F91B8B0BD580998763A9A3525AE27CC1FEC6EDBCC2C54D552", "73EE246F16541F2E64D82F0CEC4CA1C2245EEFEEFD4474C411255DF8604EB701"},
+		{"046B7BF47F18B2889F91B8B0BD580998763A9A3525AE27CC1FEC6EDBCC2C54D55273EE246F16541F2E64D82F0CEC4CA1C2245EEFEEFD4474C411255DF8604EB701", "6B7BF47F18B2889F91B8B0BD580998763A9A3525AE27CC1FEC6EDBCC2C54D552", "73EE246F16541F2E64D82F0CEC4CA1C2245EEFEEFD4474C411255DF8604EB701"},
+		{"076B7BF47F18B2889F91B8B0BD580998763A9A3525AE27CC1FEC6EDBCC2C54D55273EE246F16541F2E64D82F0CEC4CA1C2245EEFEEFD4474C411255DF8604EB701", "6B7BF47F18B2889F91B8B0BD580998763A9A3525AE27CC1FEC6EDBCC2C54D552", "73EE246F16541F2E64D82F0CEC4CA1C2245EEFEEFD4474C411255DF8604EB701"},
+		{"03A3ECDACF772556836AD8E6B322B1C10C15D04E1B45FCABF29FF4271D27952CD0", "A3ECDACF772556836AD8E6B322B1C10C15D04E1B45FCABF29FF4271D27952CD0", "AF9BC68DDE9EB7057F11EB678A6A158AEAEB192D7C3745A0E5C240D4EFE74195"},
+		{"04A3ECDACF772556836AD8E6B322B1C10C15D04E1B45FCABF29FF4271D27952CD0AF9BC68DDE9EB7057F11EB678A6A158AEAEB192D7C3745A0E5C240D4EFE74195", "A3ECDACF772556836AD8E6B322B1C10C15D04E1B45FCABF29FF4271D27952CD0", "AF9BC68DDE9EB7057F11EB678A6A158AEAEB192D7C3745A0E5C240D4EFE74195"},
+		{"07A3ECDACF772556836AD8E6B322B1C10C15D04E1B45FCABF29FF4271D27952CD0AF9BC68DDE9EB7057F11EB678A6A158AEAEB192D7C3745A0E5C240D4EFE74195", "A3ECDACF772556836AD8E6B322B1C10C15D04E1B45FCABF29FF4271D27952CD0", "AF9BC68DDE9EB7057F11EB678A6A158AEAEB192D7C3745A0E5C240D4EFE74195"},
+		{"02450BFCBBABDE2340EDC1568BE4201B0C654EA26C2ADEDE3B39D0FE97728386F4", "450BFCBBABDE2340EDC1568BE4201B0C654EA26C2ADEDE3B39D0FE97728386F4", "EACAE0C595630DEAEB958BB5244E79047D6F249B6E9760567380B6B83B1A66DC"},
+		{"04450BFCBBABDE2340EDC1568BE4201B0C654EA26C2ADEDE3B39D0FE97728386F4EACAE0C595630DEAEB958BB5244E79047D6F249B6E9760567380B6B83B1A66DC", "450BFCBBABDE2340EDC1568BE4201B0C654EA26C2ADEDE3B39D0FE97728386F4", "EACAE0C595630DEAEB958BB5244E79047D6F249B6E9760567380B6B83B1A66DC"},
+		{"06450BFCBBABDE2340EDC1568BE4201B0C654EA26C2ADEDE3B39D0FE97728386F4EACAE0C595630DEAEB958BB5244E79047D6F249B6E9760567380B6B83B1A66DC", "450BFCBBABDE2340EDC1568BE4201B0C654EA26C2ADEDE3B39D0FE97728386F4", "EACAE0C595630DEAEB958BB5244E79047D6F249B6E9760567380B6B83B1A66DC"},
+		{"02FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF", nullptr, nullptr},
+		{"02FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFC2F", nullptr, nullptr},
+		{"030000000000000000000000000000000000000000000000000000000000000005", nullptr, nullptr},
+		{"06B169E6DBBB258118800ACA302E9CD6945165E6252FFC3F9CCA5CE4A9BDE4B66426A480EBFA8AB3D694E1FF27F164763079ACE3785017E75A7D2911FDCD2EAB21", nullptr, nullptr},
+		{"04B169E6DBBB258118800ACA302E9CD6945165E6252FFC3F9CCA5CE4A9BDE4B66426A480EBFA8AB3D694E1FF27F164763079ACE3785017E75A7D2911FDCD2EAB22", nullptr, nullptr},
+		{"05B169E6DBBB258118800ACA302E9CD6945165E6252FFC3F9CCA5CE4A9BDE4B66426A480EBFA8AB3D694E1FF27F164763079ACE3785017E75A7D2911FDCD2EAB21", nullptr, nullptr},
+		{"B169E6DBBB258118800ACA302E9CD6945165E6252FFC3F9CCA5CE4A9BDE4B664", nullptr, nullptr},
+		{"04B169E6DBBB258118800ACA302E9CD6945165E6252FFC3F9CCA5CE4A9BDE4B664", nullptr, nullptr},
+		{"00", nullptr, nullptr},
+		{"", nullptr, nullptr},
+	};
+	for (const ThreeStrings &tc : cases) {
+		const Bytes bytes = hexBytes(tc.a);
+		CurvePoint p = CurvePoint::ZERO;
+		bool ok = CurvePoint::fromBytes(bytes.data(), bytes.size(), p);
+		if (tc.b == nullptr)
+			assert(!ok && p == CurvePoint::ZERO);
+		else {
+			assert(ok && p == CurvePoint(tc.b, tc.c) && p.z == CurvePoint::FI_ONE);
+			uint8_t buf[65];
+			if (bytes.size() == 33) {
+				p.toCompressedPoint(buf);
+				assert(Bytes(buf, buf + 33) == bytes);
+			} else if (bytes[0] == 0x04) {
+				p.toUncompressedPoint(buf);
+				assert(Bytes(buf, buf + 65) == bytes);
+			}
+		}
+		numTestCases++;
+	}
+	
+	// Bulk parsing of consecutive compressed keys
+	Bytes data;
+	vector<bool> expect;
+	for (const ThreeStrings &tc : cases) {
+		const Bytes bytes = hexBytes(tc.a);
+		if (bytes.size() == 33) {
+			data.insert(data.end(), bytes.begin(), bytes.end());
+			expect.push_back(tc.b != nullptr);
+		}
+	}
+	const size_t n = expect.size();
+	vector<CurvePoint> points(n, CurvePoint::G);
+	bool valid[20];
+	assert(n <= 20);
+	size_t numValid = CurvePoint::fromBytesBulk(data.data(), 33, n, points.data(), valid);
+	size_t count = 0;
+	for (size_t i = 0; i < n; i++) {
+		assert(valid[i] == expect[i]);
+		if (valid[i]) {
+			count++;
+			CurvePoint p = CurvePoint::ZERO;
+			assert(CurvePoint::fromBytes(&data[i * 33], 33, p) && points[i] == p);
+		} else
+			assert(points[i] == CurvePoint::ZERO);
+	}
+	assert(numValid == count);
+	numTestCases++;
+}
+
+
 static void testPrivateExponentToPublicPoint() {
 	const vector<ThreeStrings> cases{
 		{"0000000000000000000000000000000000000000000000000000000000000001", "79BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798", "483ADA7726A3C4655DA4FBFC0E1108A8FD17B448A68554199C47D08FFB10D4B8"},
@@ -1116,6 +1513,17 @@ static void testPrivateExponentToPublicPoint() {
 		assert(p.x == FieldInt(tc.b) && p.y == FieldInt(tc.c) && p.z == FieldInt(Uint256::ONE));
 		numTestCases++;
 	}
+	
+	// Same results with a generator table installed
+	vector<CurvePoint> genTable(CurvePoint::GENERATOR_TABLE_LEN, CurvePoint::ZERO);
+	CurvePoint::precomputeGeneratorTable(genTable.data());
+	CurvePoint::setGeneratorTable(genTable.data());
+	for (const ThreeStrings &tc : cases) {
+		CurvePoint p = CurvePoint::privateExponentToPublicPoint(Uint256(tc.a));
+		assert(p.x == FieldInt(tc.b) && p.y == FieldInt(tc.c) && p.z == FieldInt(Uint256::ONE));
+		numTestCases++;
+	}
+	CurvePoint::setGeneratorTable(nullptr);
 }
 
 
@@ -1124,9 +1532,17 @@ int main() {
 	testTwice();
 	testAdd();
 	testMultiply();
+	testMultiplyGlv();
+	testMultiplyX();
+	testSplitScalar();
 	testMultiplyModOrder();
+	testDoubleMultiply();
+	testMultiScalarMultiply();
 	testIsOnCurve();
 	testPrivateExponentToPublicPoint();
+	testFromBytes();
+	testEquality();
+	testHasXModOrder();
 	std::printf("All %d test cases passed\n", numTestCases);
 	return EXIT_SUCCESS;
 }
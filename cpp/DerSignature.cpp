@@ -0,0 +1,158 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include <cassert>
+#include "DerSignature.hpp"
+
+using std::size_t;
+using std::uint8_t;
+using std::uint32_t;
+
+
+size_t DerSignature::encode(const Uint256 &r, const Uint256 &s, uint8_t out[MAX_LEN]) {
+	assert(out != nullptr && r != Uint256::ZERO && s != Uint256::ZERO);
+	size_t len = encodeInteger(s, out, encodeInteger(r, out, 2));
+	out[0] = 0x30;
+	out[1] = static_cast<uint8_t>(len - 2);
+	return len;
+}
+
+
+bool DerSignature::decodeStrict(const uint8_t sig[], size_t len, Uint256 &outR, Uint256 &outS) {
+	// Same checks as IsValidSignatureEncoding() of BIP 66, minus the sighash byte
+	assert(sig != nullptr || len == 0);
+	if (len < 8 || len > MAX_LEN)
+		return false;
+	if (sig[0] != 0x30 || sig[1] != len - 2)
+		return false;
+	size_t lenR = sig[3];
+	if (5 + lenR >= len)
+		return false;
+	size_t lenS = sig[5 + lenR];
+	if (lenR + lenS + 6 != len)
+		return false;
+	
+	if (sig[2] != 0x02 || lenR == 0 || (sig[4] & 0x80) != 0)
+		return false;
+	if (lenR > 1 && sig[4] == 0x00 && (sig[5] & 0x80) == 0)  // Excess padding
+		return false;
+	if (sig[lenR + 4] != 0x02 || lenS == 0 || (sig[lenR + 6] & 0x80) != 0)
+		return false;
+	if (lenS > 1 && sig[lenR + 6] == 0x00 && (sig[lenR + 7] & 0x80) == 0)
+		return false;
+	
+	readInteger(&sig[4], lenR, outR);
+	readInteger(&sig[lenR + 6], lenS, outS);
+	return true;
+}
+
+
+bool DerSignature::decodeLax(const uint8_t sig[], size_t len, Uint256 &outR, Uint256 &outS) {
+	// Follows ecdsa_signature_parse_der_lax() of Bitcoin Core
+	assert(sig != nullptr || len == 0);
+	size_t pos = 0;
+	
+	// Sequence tag and length, whose value is ignored
+	if (pos == len || sig[pos] != 0x30)
+		return false;
+	pos++;
+	if (pos == len)
+		return false;
+	size_t lenByte = sig[pos];
+	pos++;
+	if ((lenByte & 0x80) != 0) {
+		lenByte -= 0x80;
+		if (lenByte > len - pos)
+			return false;
+		pos += lenByte;
+	}
+	
+	// The two integers
+	size_t intPos[2];
+	size_t intLen[2];
+	for (int i = 0; i < 2; i++) {
+		if (pos == len || sig[pos] != 0x02)
+			return false;
+		pos++;
+		if (pos == len)
+			return false;
+		lenByte = sig[pos];
+		pos++;
+		size_t n = lenByte;
+		if ((lenByte & 0x80) != 0) {
+			lenByte -= 0x80;
+			if (lenByte > len - pos)
+				return false;
+			for (; lenByte > 0 && sig[pos] == 0; lenByte--)
+				pos++;
+			if (lenByte >= 4)
+				return false;
+			n = 0;
+			for (; lenByte > 0; lenByte--, pos++)
+				n = (n << 8) | sig[pos];
+		}
+		if (n > len - pos)
+			return false;
+		intPos[i] = pos;
+		intLen[i] = n;
+		pos += n;
+	}
+	
+	Uint256 r, s;
+	if (!readInteger(&sig[intPos[0]], intLen[0], r) || !readInteger(&sig[intPos[1]], intLen[1], s)) {
+		r = Uint256::ZERO;
+		s = Uint256::ZERO;
+	}
+	outR = r;
+	outS = s;
+	return true;
+}
+
+
+bool DerSignature::isLowS(const Uint256 &s) {
+	return s <= HALF_ORDER;
+}
+
+
+size_t DerSignature::encodeInteger(const Uint256 &val, uint8_t out[MAX_LEN], size_t pos) {
+	uint8_t bytes[Uint256::NUM_WORDS * 4];
+	val.getBigEndianBytes(bytes);
+	size_t start = 0;
+	while (bytes[start] == 0)
+		start++;
+	size_t n = sizeof(bytes) - start;
+	bool pad = (bytes[start] & 0x80) != 0;  // Keep the integer positive
+	out[pos] = 0x02;
+	out[pos + 1] = static_cast<uint8_t>(n + (pad ? 1 : 0));
+	pos += 2;
+	if (pad) {
+		out[pos] = 0x00;
+		pos++;
+	}
+	for (size_t i = start; i < sizeof(bytes); i++, pos++)
+		out[pos] = bytes[i];
+	return pos;
+}
+
+
+bool DerSignature::readInteger(const uint8_t bytes[], size_t len, Uint256 &out) {
+	while (len > 0 && bytes[0] == 0) {
+		bytes++;
+		len--;
+	}
+	out = Uint256::ZERO;
+	if (len > Uint256::NUM_WORDS * 4)
+		return false;
+	for (size_t i = 0; i < len; i++)
+		out.value[i >> 2] |= static_cast<uint32_t>(bytes[len - 1 - i]) << ((i & 3) << 3);
+	return true;
+}
+
+
+// Static initializers
+const Uint256 DerSignature::HALF_ORDER("7FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF5D576E7357A4501DDFE92F46681B20A0");
@@ -0,0 +1,78 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "Uint256.hpp"
+
+
+/* 
+ * Converts ECDSA signature values (r, s) to and from the DER encoding used in Bitcoin transactions:
+ * 0x30 len 0x02 lenR R 0x02 lenS S, where R and S are minimal big-endian signed integers. The byte arrays
+ * here never include the sighash type byte that follows a signature in a script. Encoding writes into the
+ * caller's buffer, and decoding reads the integers straight from the input into the Uint256 outputs;
+ * nothing is allocated. Provides just a few static functions. All functions are not constant-time,
+ * because signatures are public data.
+ */
+class DerSignature final {
+	
+	/*---- Public constants ----*/
+	
+	public: static constexpr std::size_t MAX_LEN = 72;  // For 33-byte R and S
+	
+	
+	
+	/*---- Public functions ----*/
+	
+	// Writes the DER encoding of the given signature values to the output array and returns its length,
+	// which is between 8 and MAX_LEN bytes. Requires r and s to be nonzero.
+	public: static std::size_t encode(const Uint256 &r, const Uint256 &s, std::uint8_t out[MAX_LEN]);
+	
+	
+	// Parses the given bytes under the strict DER rules of BIP 66, which also bound the length to [8, MAX_LEN].
+	// Returns true and sets outR and outS if the encoding is valid; otherwise returns false and leaves them unchanged.
+	// An integer that does not fit in 256 bits is accepted (as consensus does) but decoded as 0, which never verifies.
+	public: static bool decodeStrict(const std::uint8_t sig[], std::size_t len, Uint256 &outR, Uint256 &outS);
+	
+	
+	// Parses the given bytes leniently, like OpenSSL did before BIP 66 and like Bitcoin Core's parser for old
+	// signatures: lengths may be non-minimal or in long form, integers may have excess leading zeros or look
+	// negative, and data after the integers is ignored. Returns false only if the structure cannot be followed.
+	// If either integer does not fit in 256 bits, then both outputs are set to 0, which never verifies.
+	public: static bool decodeLax(const std::uint8_t sig[], std::size_t len, Uint256 &outR, Uint256 &outS);
+	
+	
+	// Tests whether the given s value is at most CurvePoint::ORDER / 2, as BIP 62 and BIP 146 require.
+	// Ecdsa::sign() always produces such values.
+	public: static bool isLowS(const Uint256 &s);
+	
+	
+	
+	/*---- Private helper functions ----*/
+	
+	// Writes 0x02, the length, and the minimal encoding of the given nonzero value at out[pos],
+	// and returns the position after it.
+	private: static std::size_t encodeInteger(const Uint256 &val, std::uint8_t out[MAX_LEN], std::size_t pos);
+	
+	
+	// Sets out to the big-endian unsigned value of the given bytes, ignoring leading zeros. Returns false
+	// (and sets out to 0) if the value does not fit in 256 bits.
+	private: static bool readInteger(const std::uint8_t bytes[], std::size_t len, Uint256 &out);
+	
+	
+	
+	/*---- Class constants ----*/
+	
+	private: static const Uint256 HALF_ORDER;  // floor(CurvePoint::ORDER / 2)
+	
+	
+	DerSignature() = delete;  // Not instantiable
+	
+};
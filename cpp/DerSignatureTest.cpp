@@ -0,0 +1,156 @@
+/* 
+ * A runnable main program that tests the functionality of class DerSignature.
+ * 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include "TestHelper.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "CurvePoint.hpp"
+#include "DerSignature.hpp"
+#include "Ecdsa.hpp"
+#include "Sha256.hpp"
+#include "Uint256.hpp"
+
+using std::uint8_t;
+
+
+// Global variables
+static int numTestCases = 0;
+
+
+/*---- Test cases ----*/
+
+static void testEncodeAndDecode() {
+	struct TestCase {
+		const char *r;
+		const char *s;
+		const char *der;
+	};
+	const vector<TestCase> cases{
+		{"0000000000000000000000000000000000000000000000000000000000000001", "0000000000000000000000000000000000000000000000000000000000000002", "3006020101020102"},
+		{"0000000000000000000000000000000000000000000000000000000000000080", "000000000000000000000000000000000000000000000000000000000000007F", "30070202008002017F"},
+		{"934B1EA10A4B3C1757E2B0C017D0B6143CE3C9A7E6A4A49860D7A6AB210EE3D8", "2442CE9D2B916064108014783E923EC36B49743E2FFA1C4496F01A512AAFD9E5",
+			"3045022100934B1EA10A4B3C1757E2B0C017D0B6143CE3C9A7E6A4A49860D7A6AB210EE3D802202442CE9D2B916064108014783E923EC36B49743E2FFA1C4496F01A512AAFD9E5"},
+		{"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364140", "8000000000000000000000000000000000000000000000000000000000000000",
+			"3046022100FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD03641400221008000000000000000000000000000000000000000000000000000000000000000"},
+	};
+	for (const TestCase &tc : cases) {
+		const Uint256 r(tc.r);
+		const Uint256 s(tc.s);
+		Bytes expect = hexBytes(tc.der);
+		uint8_t buf[DerSignature::MAX_LEN];
+		size_t len = DerSignature::encode(r, s, buf);
+		assert(len == expect.size() && std::memcmp(buf, expect.data(), len) == 0);
+		
+		Uint256 actualR, actualS;
+		assert(DerSignature::decodeStrict(buf, len, actualR, actualS));
+		assert(actualR == r && actualS == s);
+		actualR = Uint256::ZERO;
+		actualS = Uint256::ZERO;
+		assert(DerSignature::decodeLax(buf, len, actualR, actualS));
+		assert(actualR == r && actualS == s);
+		numTestCases++;
+	}
+}
+
+
+static void testStrictRejects() {
+	const char *cases[] = {
+		"",
+		"3006020101020102FF",  // Trailing byte
+		"3106020101020102",  // Wrong sequence tag
+		"3007020101020102",  // Wrong sequence length
+		"3006030101020102",  // Wrong integer tag
+		"3006020201020102",  // Wrong R length
+		"3006020001020102",  // Zero-length R (also misframed)
+		"3006020181020102",  // Negative R
+		"300702020001020102",  // Padded R
+		"300702010102020002",  // Padded S
+		"3006020101020182",  // Negative S
+		"30080201010281010200",  // Long-form length
+	};
+	for (const char *hex : cases) {
+		Bytes sig = hexBytes(hex);
+		Uint256 r = Uint256::ONE;
+		Uint256 s = Uint256::ONE;
+		assert(!DerSignature::decodeStrict(sig.data(), sig.size(), r, s));
+		assert(r == Uint256::ONE && s == Uint256::ONE);
+		numTestCases++;
+	}
+}
+
+
+static void testLax() {
+	struct TestCase {
+		const char *der;
+		bool ok;
+		std::uint32_t r;  // Expected values when ok
+		std::uint32_t s;
+	};
+	const vector<TestCase> cases{
+		{"3006020101020102FF", true, 1, 2},  // Trailing data
+		{"3045020101020102", true, 1, 2},  // Wrong sequence length
+		{"308100020101020102", true, 1, 2},  // Long-form sequence length
+		{"300A02030000010281020002", true, 1, 2},  // Padding and long-form integer length
+		{"3006020181020182", true, 0x81, 0x82},  // Negative-looking integers are read as unsigned
+		{"30050200020102", true, 0, 2},  // Empty R
+		{"3027022201000000000000000000000000000000000000000000000000000000000000000000020102", true, 0, 0},  // R too large
+		{"", false, 0, 0},
+		{"30", false, 0, 0},
+		{"3006020501020102", false, 0, 0},  // R past the end
+		{"30060201010302", false, 0, 0},  // Wrong S tag
+		{"3006028401020102", false, 0, 0},  // Long-form length past the end
+		{"30FF020101020102", false, 0, 0},  // Long-form sequence length past the end
+	};
+	for (const TestCase &tc : cases) {
+		Bytes sig = hexBytes(tc.der);
+		Uint256 r = Uint256::ONE;
+		Uint256 s = Uint256::ONE;
+		assert(DerSignature::decodeLax(sig.data(), sig.size(), r, s) == tc.ok);
+		if (tc.ok) {
+			Uint256 expectR = Uint256::ZERO;
+			Uint256 expectS = Uint256::ZERO;
+			expectR.value[0] = tc.r;
+			expectS.value[0] = tc.s;
+			assert(r == expectR && s == expectS);
+		} else
+			assert(r == Uint256::ONE && s == Uint256::ONE);
+		numTestCases++;
+	}
+}
+
+
+static void testLowS() {
+	Uint256 half("7FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF5D576E7357A4501DDFE92F46681B20A0");
+	assert(DerSignature::isLowS(Uint256::ONE));
+	assert(DerSignature::isLowS(half));
+	half.add(Uint256::ONE);
+	assert(!DerSignature::isLowS(half));
+	numTestCases++;
+	
+	const Uint256 privKey("C85AFBACCF3E1EE40BDCD721A9AD1341344775D51840EFC0511E0182AE92F78E");
+	for (int i = 0; i < 20; i++) {
+		uint8_t msg = static_cast<uint8_t>(i);
+		Uint256 r, s;
+		assert(Ecdsa::signWithHmacNonce(privKey, Sha256::getHash(&msg, 1), r, s));
+		assert(DerSignature::isLowS(s));
+		numTestCases++;
+	}
+}
+
+
+int main() {
+	testEncodeAndDecode();
+	testStrictRejects();
+	testLax();
+	testLowS();
+	std::printf("All %d test cases passed\n", numTestCases);
+	return EXIT_SUCCESS;
+}
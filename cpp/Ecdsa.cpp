@@ -10,15 +10,29 @@
 #include <cstdint>
 #include <cstring>
 #include "CountOps.hpp"
+#include "DerSignature.hpp"
 #include "Ecdsa.hpp"
 #include "FieldInt.hpp"
+#include "PointBatch.hpp"
+#include "PublicKeyCache.hpp"
+#include "Rfc6979.hpp"
 #include "Sha256.hpp"
+#include "SignatureCache.hpp"
 
+using std::size_t;
 using std::uint8_t;
 using std::uint32_t;
+using std::uint64_t;
 
 
 bool Ecdsa::sign(const Uint256 &privateKey, const Sha256Hash &msgHash, const Uint256 &nonce, Uint256 &outR, Uint256 &outS) {
+	int recId;
+	return signRecoverable(privateKey, msgHash, nonce, outR, outS, recId);
+}
+
+
+bool Ecdsa::signRecoverable(const Uint256 &privateKey, const Sha256Hash &msgHash, const Uint256 &nonce,
+		Uint256 &outR, Uint256 &outS, int &outRecId) {
 	/* 
 	 * Algorithm pseudocode:
 	 * if (nonce outside range [1, order-1]) return false
@@ -28,6 +42,7 @@ bool Ecdsa::sign(const Uint256 &privateKey, const Sha256Hash &msgHash, const Uin
 	 * s = nonce^-1 * (msgHash + r * privateKey) % order
 	 * if (s == 0) return false
 	 * s = min(s, order - s)
+	 * recId = (p.y is odd, flipped if s was negated) + (p.x >= order ? 2 : 0)
 	 */
 	countOps(functionOps);
 	
@@ -38,14 +53,255 @@ bool Ecdsa::sign(const Uint256 &privateKey, const Sha256Hash &msgHash, const Uin
 	countOps(2 * arithmeticOps);
 	
 	const CurvePoint p = CurvePoint::privateExponentToPublicPoint(nonce);
+	Uint256 kInv = nonce;
+	kInv.reciprocal(order);
+	countOps(1 * uint256CopyOps);
+	countOps(1 * curvepointCopyOps);
+	return finishSignature(privateKey, msgHash, p, kInv, outR, outS, &outRecId);
+}
+
+
+bool Ecdsa::signWithHmacNonce(const Uint256 &privateKey, const Sha256Hash &msgHash, Uint256 &outR, Uint256 &outS) {
+	return sign(privateKey, msgHash, getHmacNonce(privateKey, msgHash), outR, outS);
+}
+
+
+void Ecdsa::signWithRfc6979Nonce(const Uint256 &privateKey, const Sha256Hash &msgHash, Uint256 &outR, Uint256 &outS,
+		const uint8_t extra[], size_t extraLen) {
+	Rfc6979 gen(privateKey, msgHash, extra, extraLen);
+	while (!sign(privateKey, msgHash, gen.next(), outR, outS));
+}
+
+
+bool Ecdsa::signWithPrecomputedNonce(const Uint256 &privateKey, const Sha256Hash &msgHash,
+		const CurvePoint &noncePoint, const Uint256 &nonceInverse, Uint256 &outR, Uint256 &outS) {
+	return finishSignature(privateKey, msgHash, noncePoint, nonceInverse, outR, outS, nullptr);
+}
+
+
+void Ecdsa::signBatch(const Uint256 privateKeys[], const Sha256Hash msgHashes[], const Uint256 nonces[],
+		size_t n, Uint256 outRs[], Uint256 outSs[], bool results[]) {
+	/* 
+	 * Algorithm pseudocode, for each chunk of items:
+	 * k[i] = nonces != null ? nonces[i] : HMAC nonce as in signWithHmacNonce()
+	 * ok[i] = (k[i] in range [1, order-1]), and k[i] = 1 if not
+	 * p[i] = k[i] * G  // Normalized together, with one field inversion
+	 * kInv[i] = k[i]^-1 % order  // All items share one inversion
+	 * results[i] = ok[i] && (the remaining steps of sign() with p[i] and kInv[i] succeed)
+	 */
+	assert((privateKeys != nullptr && msgHashes != nullptr && outRs != nullptr && outSs != nullptr && results != nullptr) || n == 0);
+	countOps(functionOps);
+	const Uint256 &order = CurvePoint::ORDER;
+	const Uint256 &zero = Uint256::ZERO;
+	for (size_t start = 0; start < n; start += BATCH_CHUNK) {
+		countOps(loopBodyOps);
+		size_t len = BATCH_CHUNK;
+		if (n - start < len)
+			len = n - start;
+		countOps(4 * arithmeticOps);
+		
+		Uint256 kInvs[BATCH_CHUNK];
+		PointBatch points(static_cast<int>(len));
+		for (size_t i = 0; i < len; i++) {
+			countOps(loopBodyOps);
+			Uint256 &k = kInvs[i];
+			k = nonces != nullptr ? nonces[start + i] : getHmacNonce(privateKeys[start + i], msgHashes[start + i]);
+			bool ok = zero < k && k < order;
+			k.replace(Uint256::ONE, static_cast<uint32_t>(!ok));  // Keep the product invertible
+			results[start + i] = ok;
+			points.set(static_cast<int>(i), CurvePoint::multiplyGenerator(k));
+			countOps(4 * arithmeticOps);
+			countOps(1 * uint256CopyOps);
+			countOps(1 * curvepointCopyOps);
+		}
+		points.normalize();
+		reciprocalBatchModOrder(kInvs, len);
+		
+		for (size_t i = 0; i < len; i++) {
+			countOps(loopBodyOps);
+			size_t j = start + i;
+			if (results[j]) {
+				results[j] = finishSignature(privateKeys[j], msgHashes[j],
+					points.get(static_cast<int>(i)), kInvs[i], outRs[j], outSs[j], nullptr);
+			}
+			countOps(1 * curvepointCopyOps);
+		}
+	}
+}
+
+
+bool Ecdsa::verify(const CurvePoint &publicKey, const Sha256Hash &msgHash, const Uint256 &r, const Uint256 &s) {
+	countOps(functionOps);
+	return verifyDetailed(publicKey, msgHash, r, s, false) == VERIFY_VALID;
+}
+
+
+Ecdsa::VerifyResult Ecdsa::verifyDetailed(const CurvePoint &publicKey, const Sha256Hash &msgHash,
+		const Uint256 &r, const Uint256 &s, bool requireLowS) {
+	/* 
+	 * Algorithm pseudocode:
+	 * if (!(0 < r, s < order) || (requireLowS && s > order / 2))
+	 *   return the failed check
+	 * if (pubKey == zero || !(pubKey is normalized) || !(pubKey on curve))
+	 *   return VERIFY_BAD_PUBLIC_KEY
+	 * return verify(PublicKey(pubKey), msgHash, r, s) ? VERIFY_VALID : VERIFY_MISMATCH
+	 * (The check n * pubKey == zero is unnecessary because the curve's cofactor is 1.)
+	 */
+	countOps(functionOps);
+	VerifyResult result = checkSignatureRange(r, s, requireLowS);
+	if (result == VERIFY_VALID && (publicKey.z != CurvePoint::FI_ONE || !publicKey.isOnCurve()))  // Also rejects zero
+		result = VERIFY_BAD_PUBLIC_KEY;
+	if (result == VERIFY_VALID)
+		result = verifyEquation(publicKey, msgHash, r, s);
+	verifyResultCounts[result]++;
+	countOps(4 * arithmeticOps);
+	return result;
+}
+
+
+Ecdsa::VerifyResult Ecdsa::verifyDetailed(const uint8_t publicKey[], size_t publicKeyLen, const Sha256Hash &msgHash,
+		const Uint256 &r, const Uint256 &s, bool requireLowS) {
+	countOps(functionOps);
+	VerifyResult result = checkSignatureRange(r, s, requireLowS);
+	CurvePoint q = CurvePoint::ZERO;
+	if (result == VERIFY_VALID && !CurvePoint::fromBytes(publicKey, publicKeyLen, q))  // Decompression costs a square root
+		result = VERIFY_BAD_PUBLIC_KEY;
+	if (result == VERIFY_VALID)
+		result = verifyEquation(q, msgHash, r, s);
+	verifyResultCounts[result]++;
+	countOps(3 * arithmeticOps);
+	countOps(1 * curvepointCopyOps);
+	return result;
+}
+
+
+bool Ecdsa::verify(const PublicKey &publicKey, const Sha256Hash &msgHash, const Uint256 &r, const Uint256 &s) {
+	/* 
+	 * Algorithm pseudocode:
+	 * if (!(0 < r, s < order))
+	 *   return false
+	 * w = s^-1 % order
+	 * u1 = (msgHash * w) % order
+	 * u2 = (r * w) % order
+	 * p = u1 * G + u2 * pubKey
+	 * return p != zero && r == (p.x / p.z) % order
+	 */
+	countOps(functionOps);
+	
+	const Uint256 &order = CurvePoint::ORDER;
+	const Uint256 &zero = Uint256::ZERO;
+	if (!(zero < r && r < order && zero < s && s < order))
+		return false;
+	countOps(5 * arithmeticOps);
+	
+	Uint256 w = s;
+	w.reciprocal(order);
+	const Uint256 z(msgHash.value);
+	Uint256 u1 = w;
+	Uint256 u2 = w;
+	multiplyModOrder(u1, z);
+	multiplyModOrder(u2, r);
+	countOps(4 * uint256CopyOps);
+	
+	const CurvePoint p = publicKey.hasPrecomputation() ?
+		CurvePoint::doubleMultiplyPrecomputed(u1, u2, publicKey.getTable()) :
+		CurvePoint::doubleMultiplyGenerator(u1, u2, publicKey.getPoint());
+	countOps(1 * arithmeticOps);
+	countOps(1 * curvepointCopyOps);
+	return p.hasXModOrder(r);  // No normalization needed
+}
+
+
+void Ecdsa::verifyBatch(const CurvePoint publicKeys[], const Sha256Hash msgHashes[],
+		const Uint256 rs[], const Uint256 ss[], size_t n, bool results[]) {
+	/* 
+	 * Algorithm pseudocode, for each chunk of items:
+	 * valid[i] = (the range and public key checks of verify() pass)
+	 * w[i] = s[i]^-1 % order  // All valid items share one inversion
+	 * p[i] = u1[i] * G + u2[i] * pubKey[i]  // As in verify()
+	 * results[i] = valid[i] && p[i] != zero && r[i] == (p[i].x / p[i].z) % order  // Without inversion
+	 */
+	assert((publicKeys != nullptr && msgHashes != nullptr && rs != nullptr && ss != nullptr && results != nullptr) || n == 0);
+	countOps(functionOps);
+	if (n == 1) {  // Nothing to share
+		results[0] = verify(publicKeys[0], msgHashes[0], rs[0], ss[0]);
+		return;
+	}
+	
+	SignatureCache *sigCache = signatureCache.load();
+	for (size_t start = 0; start < n; start += BATCH_CHUNK) {
+		countOps(loopBodyOps);
+		size_t len = BATCH_CHUNK;
+		if (n - start < len)
+			len = n - start;
+		const CurvePoint *pubKeys = &publicKeys[start];
+		const Uint256 *r = &rs[start];
+		const Uint256 *s = &ss[start];
+		bool *ok = &results[start];
+		countOps(6 * arithmeticOps);
+		
+		// Check the inputs, the same way as verify(), and skip the signatures already known to be valid
+		Uint256 w[BATCH_CHUNK];
+		VerifyResult status[BATCH_CHUNK];
+		bool cached[BATCH_CHUNK];
+		size_t numValid = 0;
+		for (size_t i = 0; i < len; i++) {
+			countOps(loopBodyOps);
+			const CurvePoint &q = pubKeys[i];
+			status[i] = checkSignatureRange(r[i], s[i], false);
+			if (status[i] == VERIFY_VALID && (q.z != CurvePoint::FI_ONE || !q.isOnCurve()))
+				status[i] = VERIFY_BAD_PUBLIC_KEY;
+			ok[i] = status[i] == VERIFY_VALID;
+			cached[i] = ok[i] && sigCache != nullptr && sigCache->contains(q, msgHashes[start + i], r[i], s[i]);
+			if (ok[i] && !cached[i]) {
+				w[numValid] = s[i];
+				numValid++;
+			}
+			countOps(10 * arithmeticOps);
+			countOps(1 * uint256CopyOps);
+		}
+		reciprocalBatchModOrder(w, numValid);
+		
+		// Compute the points and compare them with r in projective coordinates
+		for (size_t i = 0, j = 0; i < len; i++) {
+			countOps(loopBodyOps);
+			if (!ok[i] || cached[i])
+				continue;
+			const Uint256 z(msgHashes[start + i].value);
+			Uint256 u1 = w[j];
+			Uint256 u2 = w[j];
+			j++;
+			multiplyModOrder(u1, z);
+			multiplyModOrder(u2, r[i]);
+			const CurvePoint p = CurvePoint::doubleMultiplyGenerator(u1, u2, pubKeys[i]);
+			ok[i] = p.hasXModOrder(r[i]);
+			if (ok[i] && sigCache != nullptr)
+				sigCache->insert(pubKeys[i], msgHashes[start + i], r[i], s[i]);
+			else if (!ok[i])
+				status[i] = VERIFY_MISMATCH;
+			countOps(2 * arithmeticOps);
+			countOps(3 * uint256CopyOps);
+			countOps(1 * curvepointCopyOps);
+		}
+		for (size_t i = 0; i < len; i++)
+			verifyResultCounts[status[i]]++;
+	}
+}
+
+
+bool Ecdsa::finishSignature(const Uint256 &privateKey, const Sha256Hash &msgHash, const CurvePoint &p,
+		const Uint256 &kInv, Uint256 &outR, Uint256 &outS, int *outRecId) {
+	countOps(functionOps);
+	const Uint256 &order = CurvePoint::ORDER;
+	const Uint256 &zero = Uint256::ZERO;
 	Uint256 r(p.x);
-	r.subtract(order, static_cast<uint32_t>(r >= order));
+	uint32_t overflow = static_cast<uint32_t>(r >= order);
+	r.subtract(order, overflow);
 	if (r == zero)
 		return false;
 	assert(r < order);
 	countOps(1 * arithmeticOps);
 	countOps(1 * uint256CopyOps);
-	countOps(1 * curvepointCopyOps);
 	
 	Uint256 s = r;
 	const Uint256 z(msgHash.value);
@@ -55,115 +311,266 @@ bool Ecdsa::sign(const Uint256 &privateKey, const Sha256Hash &msgHash, const Uin
 	countOps(1 * arithmeticOps);
 	countOps(2 * uint256CopyOps);
 	
-	Uint256 kInv = nonce;
-	kInv.reciprocal(order);
 	multiplyModOrder(s, kInv);
 	if (s == zero)
 		return false;
 	countOps(1 * arithmeticOps);
-	countOps(1 * uint256CopyOps);
 	
 	Uint256 negS = order;
 	negS.subtract(s);
-	s.replace(negS, static_cast<uint32_t>(negS < s));  // To ensure low S values for BIP 62
+	uint32_t negate = static_cast<uint32_t>(negS < s);
+	s.replace(negS, negate);  // To ensure low S values for BIP 62
 	outR = r;
 	outS = s;
+	if (outRecId != nullptr)  // Negating s corresponds to negating the nonce point
+		*outRecId = static_cast<int>(((p.y.value[0] & 1) ^ negate) | (overflow << 1));
+	countOps(4 * arithmeticOps);
 	countOps(3 * uint256CopyOps);
 	return true;
 }
 
 
-bool Ecdsa::signWithHmacNonce(const Uint256 &privateKey, const Sha256Hash &msgHash, Uint256 &outR, Uint256 &outS) {
+Uint256 Ecdsa::getHmacNonce(const Uint256 &privateKey, const Sha256Hash &msgHash) {
 	uint8_t privkeyBytes[Uint256::NUM_WORDS * 4];
 	privateKey.getBigEndianBytes(privkeyBytes);
 	const Sha256Hash hmac = Sha256::getHmac(privkeyBytes, sizeof(privkeyBytes), msgHash.value, Sha256Hash::HASH_LEN);
-	const Uint256 nonce(hmac.value);
-	return sign(privateKey, msgHash, nonce, outR, outS);
+	return Uint256(hmac.value);
 }
 
 
-bool Ecdsa::verify(const CurvePoint &publicKey, const Sha256Hash &msgHash, const Uint256 &r, const Uint256 &s) {
+bool Ecdsa::recover(const Sha256Hash &msgHash, const Uint256 &r, const Uint256 &s, int recId, CurvePoint &outPublicKey) {
 	/* 
 	 * Algorithm pseudocode:
-	 * if (pubKey == zero || !(pubKey is normalized) ||
-	 *     !(pubKey on curve) || n * pubKey != zero)
+	 * if (!(0 < r, s < order) || !(0 <= recId < 4))
 	 *   return false
-	 * if (!(0 < r, s < order))
-	 *   return false
-	 * w = s^-1 % order
-	 * u1 = (msgHash * w) % order
-	 * u2 = (r * w) % order
-	 * p = u1 * G + u2 * pubKey
-	 * return r == p.x % order
+	 * p = the curve point with x = r + (recId >= 2 ? order : 0) and y parity recId % 2
+	 * w = r^-1 % order
+	 * u1 = -(msgHash * w) % order
+	 * u2 = (s * w) % order
+	 * q = u1 * G + u2 * p
+	 * return q != zero
 	 */
 	countOps(functionOps);
-	countOps(11 * arithmeticOps);
-	
 	const Uint256 &order = CurvePoint::ORDER;
 	const Uint256 &zero = Uint256::ZERO;
-	CurvePoint q = publicKey;
-	q.multiply(CurvePoint::ORDER);
-	if (!(zero < r && r < order && zero < s && s < order))
+	if (!(zero < r && r < order && zero < s && s < order) || recId < 0 || recId > 3)
 		return false;
-	countOps(5 * arithmeticOps);
-	if (publicKey.isZero() || publicKey.z != CurvePoint::FI_ONE || !publicKey.isOnCurve() || !q.isZero())
+	countOps(6 * arithmeticOps);
+	
+	// Decompress the nonce point, which fails if x is not less than the field modulus or not on the curve
+	Uint256 x = r;
+	if ((recId & 2) != 0 && x.add(order) != 0)
+		return false;
+	uint8_t encoded[33];
+	encoded[0] = static_cast<uint8_t>(0x02 | (recId & 1));
+	x.getBigEndianBytes(&encoded[1]);
+	CurvePoint p = CurvePoint::ZERO;
+	if (!CurvePoint::fromBytes(encoded, sizeof(encoded), p))
 		return false;
 	countOps(4 * arithmeticOps);
+	countOps(1 * uint256CopyOps);
 	countOps(1 * curvepointCopyOps);
 	
-	Uint256 w = s;
+	Uint256 w = r;
 	w.reciprocal(order);
-	const Uint256 z(msgHash.value);
-	Uint256 u1 = w;
-	Uint256 u2 = w;
-	multiplyModOrder(u1, z);
-	multiplyModOrder(u2, r);
-	countOps(4 * uint256CopyOps);
+	Uint256 u1(msgHash.value);
+	u1.subtract(order, static_cast<uint32_t>(u1 >= order));
+	multiplyModOrder(u1, w);
+	Uint256 negU1 = order;
+	negU1.subtract(u1);
+	u1.replace(negU1, static_cast<uint32_t>(u1 != zero));
+	Uint256 u2 = s;
+	multiplyModOrder(u2, w);
+	countOps(3 * arithmeticOps);
+	countOps(5 * uint256CopyOps);
 	
-	CurvePoint p = CurvePoint::G;
-	q = publicKey;
-	p.multiply(u1);
-	q.multiply(u2);
-	p.add(q);
-	p.normalize();
+	CurvePoint q = CurvePoint::doubleMultiplyGenerator(u1, u2, p);
+	if (q.isZero())
+		return false;
+	q.normalize();
+	outPublicKey = q;
+	countOps(1 * arithmeticOps);
 	countOps(2 * curvepointCopyOps);
+	return true;
+}
+
+
+void Ecdsa::toCompactSignature(const Uint256 &r, const Uint256 &s, int recId, bool compressedKey, uint8_t out[COMPACT_SIGNATURE_LEN]) {
+	assert(0 <= recId && recId < 4);
+	out[0] = static_cast<uint8_t>(27 + recId + (compressedKey ? 4 : 0));
+	r.getBigEndianBytes(&out[1]);
+	s.getBigEndianBytes(&out[33]);
+}
+
+
+bool Ecdsa::fromCompactSignature(const uint8_t sig[COMPACT_SIGNATURE_LEN], Uint256 &outR, Uint256 &outS, int &outRecId, bool &outCompressedKey) {
+	assert(sig != nullptr);
+	int header = sig[0];
+	if (header < 27 || header >= 35)
+		return false;
+	const Uint256 r(&sig[1]);
+	const Uint256 s(&sig[33]);
+	const Uint256 &order = CurvePoint::ORDER;
+	if (r == Uint256::ZERO || r >= order || s == Uint256::ZERO || s >= order)
+		return false;
+	outR = r;
+	outS = s;
+	outRecId = (header - 27) & 3;
+	outCompressedKey = header >= 31;
+	return true;
+}
+
+
+void Ecdsa::setPublicKeyCache(PublicKeyCache *cache) {
+	publicKeyCache.store(cache);
+}
+
+
+void Ecdsa::setSignatureCache(SignatureCache *cache) {
+	signatureCache.store(cache);
+}
+
+
+uint64_t Ecdsa::getVerifyResultCount(VerifyResult result) {
+	assert(0 <= result && result < NUM_VERIFY_RESULTS);
+	return verifyResultCounts[result].load();
+}
+
+
+void Ecdsa::resetVerifyResultCounts() {
+	for (std::atomic<uint64_t> &count : verifyResultCounts)
+		count.store(0);
+}
+
+
+Ecdsa::VerifyResult Ecdsa::checkSignatureRange(const Uint256 &r, const Uint256 &s, bool requireLowS) {
+	countOps(functionOps);
+	const Uint256 &order = CurvePoint::ORDER;
+	const Uint256 &zero = Uint256::ZERO;
+	countOps(6 * arithmeticOps);
+	if (!(zero < r && r < order))
+		return VERIFY_BAD_R;
+	else if (!(zero < s && s < order))
+		return VERIFY_BAD_S;
+	else if (requireLowS && !DerSignature::isLowS(s))
+		return VERIFY_HIGH_S;
+	else
+		return VERIFY_VALID;
+}
+
+
+Ecdsa::VerifyResult Ecdsa::verifyEquation(const CurvePoint &publicKey, const Sha256Hash &msgHash,
+		const Uint256 &r, const Uint256 &s) {
+	countOps(functionOps);
+	SignatureCache *sigCache = signatureCache.load();
+	if (sigCache != nullptr && sigCache->contains(publicKey, msgHash, r, s))
+		return VERIFY_VALID;
 	
-	Uint256 px(p.x);
-	px.subtract(order, static_cast<uint32_t>(px >= order));
-	countOps(1 * uint256CopyOps);
-	return r == px;
+	bool valid;
+	PublicKeyCache *cache = publicKeyCache.load();
+	if (cache != nullptr) {
+		const std::shared_ptr<const PublicKey> cached = cache->get(publicKey);  // Not null, as the key is valid
+		valid = cached != nullptr && verify(*cached, msgHash, r, s);
+	} else {
+		PublicKey key;
+		valid = PublicKey::fromPoint(publicKey, key) && verify(key, msgHash, r, s);
+	}
+	if (valid && sigCache != nullptr)
+		sigCache->insert(publicKey, msgHash, r, s);
+	countOps(3 * arithmeticOps);
+	return valid ? VERIFY_VALID : VERIFY_MISMATCH;
 }
 
 
 void Ecdsa::multiplyModOrder(Uint256 &x, const Uint256 &y) {
 	/* 
-	 * Russian peasant multiplication with modular reduction at each step. Algorithm pseudocode:
-	 * z = 0
-	 * for (i = 255 .. 0) {
-	 *   z = (z * 2) % order
-	 *   if (y.bit[i] == 1)
-	 *     z = (z + x) % order
-	 * }
-	 * x = z
+	 * The order is n = 2^256 - c with c < 2^129, so 2^256 = c (mod n). Algorithm pseudocode:
+	 * t = x * y  // 512 bits
+	 * repeat 4 times:
+	 *   t = (t % 2^256) + (t / 2^256) * c  // Same value mod n; at most 386, 260, 257, then 256 bits
+	 * if (t >= n) t -= n
+	 * x = t
 	 */
 	countOps(functionOps);
-	const Uint256 &mod = CurvePoint::ORDER;
-	assert(&x != &y && x < mod);
-	Uint256 z = Uint256::ZERO;
-	countOps(1 * uint256CopyOps);
+	constexpr int numWords = Uint256::NUM_WORDS;
+	uint32_t t[numWords * 2];
+	CurvePoint::multiplyFull(x, y, t);
 	
-	for (int i = Uint256::NUM_WORDS * 32 - 1; i >= 0; i--) {
+	for (int fold = 0; fold < 4; fold++) {
 		countOps(loopBodyOps);
-		// Multiply by 2
-		uint32_t c = z.shiftLeft1();
-		z.subtract(mod, c | static_cast<uint32_t>(z >= mod));
-		// Conditionally add x
-		uint32_t enable = (y.value[i >> 5] >> (i & 31)) & 1;
-		c = z.add(x, enable);
-		z.subtract(mod, c | static_cast<uint32_t>(z >= mod));
-		assert(z < mod);
-		countOps(7 * arithmeticOps);
+		uint32_t high[numWords];
+		for (int i = 0; i < numWords; i++) {
+			high[i] = t[numWords + i];
+			t[numWords + i] = 0;
+		}
+		countOps(numWords * 2 * arithmeticOps);
+		for (int i = 0; i < numWords; i++) {
+			countOps(loopBodyOps);
+			uint32_t carry = 0;
+			for (int j = 0; j < ORDER_COMPLEMENT_WORDS; j++) {
+				countOps(loopBodyOps);
+				uint64_t sum = static_cast<uint64_t>(high[i]) * ORDER_COMPLEMENT[j];
+				sum += static_cast<uint64_t>(t[i + j]) + carry;  // Does not overflow
+				t[i + j] = static_cast<uint32_t>(sum);
+				carry = static_cast<uint32_t>(sum >> 32);
+				countOps(11 * arithmeticOps);
+			}
+			for (int j = i + ORDER_COMPLEMENT_WORDS; j < numWords * 2; j++) {  // Propagate the carry in constant time
+				uint64_t sum = static_cast<uint64_t>(t[j]) + carry;
+				t[j] = static_cast<uint32_t>(sum);
+				carry = static_cast<uint32_t>(sum >> 32);
+				countOps(5 * arithmeticOps);
+			}
+		}
 	}
-	x = z;
+	
+	for (int i = 0; i < numWords; i++) {
+		assert(t[numWords + i] == 0);
+		x.value[i] = t[i];
+	}
+	x.subtract(CurvePoint::ORDER, static_cast<uint32_t>(x >= CurvePoint::ORDER));
+	countOps(numWords * arithmeticOps);
+	countOps(2 * arithmeticOps);
+}
+
+
+void Ecdsa::reciprocalBatchModOrder(Uint256 values[], size_t n) {
+	/* 
+	 * Algorithm pseudocode (Montgomery's trick):
+	 * prefix[i] = values[0] * ... * values[i-1]
+	 * inv = (values[0] * ... * values[n-1])^-1
+	 * for (i = n-1 .. 0) {
+	 *   (values[i], inv) = (inv * prefix[i], inv * values[i])
+	 * }
+	 */
+	assert(n <= BATCH_CHUNK);
+	countOps(functionOps);
+	if (n == 0)
+		return;
+	Uint256 prefix[BATCH_CHUNK];
+	Uint256 acc = Uint256::ONE;
 	countOps(1 * uint256CopyOps);
+	for (size_t i = 0; i < n; i++) {
+		countOps(loopBodyOps);
+		assert(Uint256::ZERO < values[i] && values[i] < CurvePoint::ORDER);
+		prefix[i] = acc;
+		multiplyModOrder(acc, values[i]);
+		countOps(1 * uint256CopyOps);
+	}
+	acc.reciprocal(CurvePoint::ORDER);
+	for (size_t i = n; i-- > 0; ) {
+		countOps(loopBodyOps);
+		Uint256 inv = prefix[i];
+		multiplyModOrder(inv, acc);
+		multiplyModOrder(acc, values[i]);
+		values[i] = inv;
+		countOps(2 * uint256CopyOps);
+	}
 }
+
+
+// Static initializers
+std::atomic<PublicKeyCache *> Ecdsa::publicKeyCache(nullptr);
+std::atomic<SignatureCache *> Ecdsa::signatureCache(nullptr);
+std::atomic<uint64_t> Ecdsa::verifyResultCounts[NUM_VERIFY_RESULTS];  // Zero-initialized
+const uint32_t Ecdsa::ORDER_COMPLEMENT[ORDER_COMPLEMENT_WORDS] = {0x2FC9BEBF, 0x402DA173, 0x50B75FC4, 0x45512319, 0x00000001};
@@ -8,16 +8,40 @@
 
 #pragma once
 
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
 #include "CurvePoint.hpp"
+#include "PublicKey.hpp"
 #include "Sha256Hash.hpp"
 #include "Uint256.hpp"
 
 
+class PublicKeyCache;
+class SignatureCache;
+
+
 /* 
- * Performs ECDSA signature generation and verification. Provides just three static functions.
+ * Performs ECDSA signature generation and verification. Provides just a few static functions.
  */
 class Ecdsa final {
 	
+	public: static constexpr std::size_t COMPACT_SIGNATURE_LEN = 65;
+	
+	
+	// The outcome of verifyDetailed(), named after the first check that failed. The checks run in this order,
+	// cheapest first, so that malformed signatures are rejected before any curve arithmetic is done.
+	public: enum VerifyResult {
+		VERIFY_VALID,           // All checks passed
+		VERIFY_BAD_R,           // r is not in the range [1, CurvePoint::ORDER)
+		VERIFY_BAD_S,           // s is not in the range [1, CurvePoint::ORDER)
+		VERIFY_HIGH_S,          // s > CurvePoint::ORDER / 2, when low S values are required
+		VERIFY_BAD_PUBLIC_KEY,  // Invalid encoding, not normalized, zero, or not on the curve
+		VERIFY_MISMATCH,        // The signature equation does not hold
+		NUM_VERIFY_RESULTS,
+	};
+	
+	
 	// Computes the signature (deterministically) when given the private key, message hash, and random nonce.
 	// Returns true if signing was successful (overwhelming probability), or false if a new nonce must be chosen
 	// (vanishing probability). Both privateKey and nonce must be in the range [1, CurvePoint::ORDER).
@@ -28,21 +52,172 @@ class Ecdsa final {
 	public: static bool sign(const Uint256 &privateKey, const Sha256Hash &msgHash, const Uint256 &nonce, Uint256 &outR, Uint256 &outS);
 	
 	
+	// Same as sign(), and also sets outRecId (iff signing is successful) to the recovery ID in the range [0, 4)
+	// that recover() needs to get the public key back from the signature: bit 0 is the parity of the nonce point's
+	// y coordinate (after the low-S adjustment), and bit 1 is whether its x coordinate was reduced by the order.
+	// This has the same constant-time behavior as sign().
+	public: static bool signRecoverable(const Uint256 &privateKey, const Sha256Hash &msgHash, const Uint256 &nonce,
+		Uint256 &outR, Uint256 &outS, int &outRecId);
+	
+	
 	// Computes a deterministic nonce based on the HMAC-SHA-256 of the message hash with the private key,
 	// and then performs ECDSA signing. Returns true iff signing is successful (with overwhelming probability).
 	// This has the same constant-time behavior as sign().
 	public: static bool signWithHmacNonce(const Uint256 &privateKey, const Sha256Hash &msgHash, Uint256 &outR, Uint256 &outS);
 	
 	
+	// Performs ECDSA signing with deterministic nonces from RFC 6979 (see class Rfc6979), mixing in the given extra
+	// bytes (which can be null if extraLen is 0). If a nonce fails, signing is retried with the generator's next
+	// nonce, so this always succeeds; the privateKey must be in the range [1, CurvePoint::ORDER). Without extra
+	// data, the signatures match other RFC 6979 implementations that use low S values. Each attempt has the same
+	// constant-time behavior as sign().
+	public: static void signWithRfc6979Nonce(const Uint256 &privateKey, const Sha256Hash &msgHash, Uint256 &outR, Uint256 &outS,
+		const std::uint8_t extra[] = nullptr, std::size_t extraLen = 0);
+	
+	
+	// Performs the message-dependent part of sign() with a nonce k that was prepared in advance (see class NoncePool),
+	// given the normalized noncePoint = k * G and nonceInverse = k^-1 % CurvePoint::ORDER. Costs only a few modular
+	// multiplications, and has the same result as sign() with k. Each nonce must be used at most once. This has
+	// the same constant-time behavior as sign().
+	public: static bool signWithPrecomputedNonce(const Uint256 &privateKey, const Sha256Hash &msgHash,
+		const CurvePoint &noncePoint, const Uint256 &nonceInverse, Uint256 &outR, Uint256 &outS);
+	
+	
+	// Signs each of the n given message hashes with the private key at the same index, setting results[i], outRs[i],
+	// and outSs[i] exactly as sign() would with nonces[i], or as signWithHmacNonce() would if nonces is null. The
+	// nonce inversions and the normalizations of the nonce points are each shared across chunks of the batch.
+	// No heap memory is allocated. Successful items have the same constant-time behavior as sign().
+	public: static void signBatch(const Uint256 privateKeys[], const Sha256Hash msgHashes[], const Uint256 nonces[],
+		std::size_t n, Uint256 outRs[], Uint256 outSs[], bool results[]);
+	
+	
 	// Checks whether the given signature, message, and public key are valid together. The public key point
-	// must be normalized. This function does not need to be constant-time because all inputs are public.
+	// must be normalized. If a public key cache is installed, the key is looked up in (or added to) it. If a
+	// signature cache is installed, a signature found there is accepted at once, and a valid one is added to it.
+	// Equivalent to verifyDetailed(publicKey, msgHash, r, s, false) == VERIFY_VALID, and counted the same way.
+	// This function does not need to be constant-time because all inputs are public.
 	public: static bool verify(const CurvePoint &publicKey, const Sha256Hash &msgHash, const Uint256 &r, const Uint256 &s);
 	
 	
-	// Computes x = (x * y) % CurvePoint::ORDER. Requires x < CurvePoint::ORDER, but y is unrestricted.
+	// Same as verify(), but returns the reason for a rejection, and optionally also rejects high S values
+	// (see DerSignature::isLowS()). The range checks of r and s come first, then the public key checks,
+	// then the caches and the double-scalar multiplication. Adds 1 to the counter of the returned result.
+	// This function does not need to be constant-time because all inputs are public.
+	public: static VerifyResult verifyDetailed(const CurvePoint &publicKey, const Sha256Hash &msgHash,
+		const Uint256 &r, const Uint256 &s, bool requireLowS);
+	
+	
+	// Same as the other verifyDetailed(), but takes the public key in any encoding accepted by CurvePoint::fromBytes(),
+	// and only parses it (which costs a square root for a compressed key) after the checks of r and s pass.
+	public: static VerifyResult verifyDetailed(const std::uint8_t publicKey[], std::size_t publicKeyLen,
+		const Sha256Hash &msgHash, const Uint256 &r, const Uint256 &s, bool requireLowS);
+	
+	
+	// Checks whether the given signature, message, and already validated public key are valid together, with the
+	// same result as the other overload. Uses the key's precomputed table if it has one. This function does not
+	// need to be constant-time because all inputs are public.
+	public: static bool verify(const PublicKey &publicKey, const Sha256Hash &msgHash, const Uint256 &r, const Uint256 &s);
+	
+	
+	// Checks each of the n given signatures, setting results[i] to exactly what verify() would return for
+	// the i-th public key, message hash, r, and s. The modular inversions of s are shared across the batch,
+	// replacing each one by three modular multiplications. The double-scalar multiplication dominates the cost,
+	// so this saves only about 9% per item compared to verify(); the rest of each item costs the same.
+	// Uses the signature cache like verify(), but not the public key cache, and counts each item's result like
+	// verifyDetailed() without requiring low S. No memory is allocated. This function does not need to be constant-time.
+	public: static void verifyBatch(const CurvePoint publicKeys[], const Sha256Hash msgHashes[],
+		const Uint256 rs[], const Uint256 ss[], std::size_t n, bool results[]);
+	
+	
+	// Computes the public key that makes the given signature and message hash valid, as selected by the recovery ID
+	// from signRecoverable(). Returns true and sets outPublicKey to the normalized point if successful; otherwise
+	// (if r or s is out of range, recId is not in [0, 4), or there is no such point) returns false and leaves it
+	// unchanged. Uses one inversion modulo the order, one square root to decompress the nonce point, the same double-scalar
+	// multiplication as verify() (with G's shared wide-window table), and one field inversion to normalize the result.
+	// The square root and the normalization, which verify() does not need, make it cost about 20% more than verify() of
+	// the same signature. This function does not need to be constant-time because all inputs are public.
+	public: static bool recover(const Sha256Hash &msgHash, const Uint256 &r, const Uint256 &s, int recId, CurvePoint &outPublicKey);
+	
+	
+	// Serializes a recoverable signature in the 65-byte compact format of Bitcoin signed messages: a header byte of
+	// 27 + recId (+ 4 if the signer's public key is compressed), then r and s in big endian. Requires 0 <= recId < 4.
+	// Not constant-time.
+	public: static void toCompactSignature(const Uint256 &r, const Uint256 &s, int recId, bool compressedKey,
+		std::uint8_t out[COMPACT_SIGNATURE_LEN]);
+	
+	
+	// Parses the given 65-byte compact signature. If the header byte is in the range [27, 35) and r and s are in the
+	// range [1, CurvePoint::ORDER), then the outputs are set and true is returned. Otherwise the outputs are unchanged
+	// and false is returned. Not constant-time.
+	public: static bool fromCompactSignature(const std::uint8_t sig[COMPACT_SIGNATURE_LEN], Uint256 &outR, Uint256 &outS,
+		int &outRecId, bool &outCompressedKey);
+	
+	
+	// Installs the given cache to be used by verify(const CurvePoint &, ...), or uninstalls it if null. The cache is
+	// not owned, and must outlive its installation. Thread-safe, but verifications already in progress may still use
+	// the previous cache. The default is no cache.
+	public: static void setPublicKeyCache(PublicKeyCache *cache);
+	
+	
+	// Installs the given cache of valid signatures to be used by verify(const CurvePoint &, ...) and verifyBatch(),
+	// or uninstalls it if null. The same ownership and thread-safety rules as setPublicKeyCache() apply.
+	// The default is no cache.
+	public: static void setSignatureCache(SignatureCache *cache);
+	
+	
+	// Returns the number of verifications with the given result so far, counting calls to verify(const CurvePoint &, ...),
+	// verifyDetailed(), and each item of verifyBatch(), from all threads. Useful for spotting floods of bad signatures.
+	public: static std::uint64_t getVerifyResultCount(VerifyResult result);
+	
+	
+	// Sets all the verification result counters to zero.
+	public: static void resetVerifyResultCounts();
+	
+	
+	// Performs the steps of sign() after the nonce point p = k * G has been computed, given the normalized p and
+	// kInv = k^-1 % CurvePoint::ORDER. Has the same return value and outputs as signRecoverable(), where outRecId
+	// can be null.
+	private: static bool finishSignature(const Uint256 &privateKey, const Sha256Hash &msgHash, const CurvePoint &p,
+		const Uint256 &kInv, Uint256 &outR, Uint256 &outS, int *outRecId);
+	
+	
+	// Returns VERIFY_BAD_R, VERIFY_BAD_S, or VERIFY_HIGH_S (only if requireLowS is true)
+	// for the first check that the given values fail, or VERIFY_VALID if they pass.
+	private: static VerifyResult checkSignatureRange(const Uint256 &r, const Uint256 &s, bool requireLowS);
+	
+	
+	// Performs the expensive part of verifyDetailed() after all its cheap checks have passed,
+	// returning VERIFY_VALID or VERIFY_MISMATCH. The public key must be normalized and on the curve.
+	private: static VerifyResult verifyEquation(const CurvePoint &publicKey, const Sha256Hash &msgHash,
+		const Uint256 &r, const Uint256 &s);
+	
+	
+	// Returns the deterministic nonce used by signWithHmacNonce(), which may be out of range.
+	private: static Uint256 getHmacNonce(const Uint256 &privateKey, const Sha256Hash &msgHash);
+	
+	
+	// Computes x = (x * y) % CurvePoint::ORDER, by a full product and folding its high half with the order's special
+	// form. The inputs are unrestricted and may be the same object. Constant-time with respect to both values.
 	private: static void multiplyModOrder(Uint256 &x, const Uint256 &y);
 	
 	
+	// Replaces each of the n values by its reciprocal modulo CurvePoint::ORDER, using a single
+	// reciprocal() call (Montgomery's trick). Requires 0 < values[i] < ORDER and n <= BATCH_CHUNK.
+	private: static void reciprocalBatchModOrder(Uint256 values[], std::size_t n);
+	
+	
+	private: static constexpr std::size_t BATCH_CHUNK = 64;  // Items per shared inversion in verifyBatch() and signBatch(), bounded by stack usage
+	
+	private: static constexpr int ORDER_COMPLEMENT_WORDS = 5;
+	private: static const std::uint32_t ORDER_COMPLEMENT[ORDER_COMPLEMENT_WORDS];  // 2^256 - CurvePoint::ORDER, in little-endian words
+	
+	private: static std::atomic<PublicKeyCache *> publicKeyCache;
+	
+	private: static std::atomic<SignatureCache *> signatureCache;
+	
+	private: static std::atomic<std::uint64_t> verifyResultCounts[NUM_VERIFY_RESULTS];
+	
+	
 	Ecdsa() = delete;  // Not instantiable
 	
 };
@@ -14,10 +14,12 @@
 #include <cstdlib>
 #include <iostream>
 #include <string>
+#include <vector>
 #include "CountOps.hpp"
 #include "CurvePoint.hpp"
 #include "Ecdsa.hpp"
 #include "FieldInt.hpp"
+#include "PublicKey.hpp"
 #include "Sha256.hpp"
 #include "Sha256Hash.hpp"
 #include "Uint256.hpp"
@@ -219,6 +221,32 @@ static void doCurvePoint() {
 		x.multiply(y);
 		printOps("cpMultiply");
 	}
+	{
+		CurvePoint x = CurvePoint::G;
+		Uint256 y = Uint256::ONE;
+		opsCount = 0;
+		x.multiplyGlv(y);
+		printOps("cpMultiplyGlv");
+	}
+	{
+		CurvePoint x = CurvePoint::G;
+		Uint256 y = Uint256::ONE;
+		FieldInt z = CurvePoint::FI_ZERO;
+		opsCount = 0;
+		x.multiplyX(y, z);
+		printOps("cpMultiplyX");
+	}
+	{
+		CurvePoint x = CurvePoint::G;
+		Uint256 y("9F8C1D27E3B54A6F0D2C8B7A6E5F4D3C2B1A09F8E7D6C5B4A39281706F5E4D3C");  // Not constant-time, so use a typical scalar
+		opsCount = 0;
+		CurvePoint::doubleMultiply(y, x, y, x);
+		printOps("cpDoubleMultiply");
+		CurvePoint::doubleMultiplyGenerator(y, y, x);  // Builds the shared table for G
+		opsCount = 0;
+		CurvePoint::doubleMultiplyGenerator(y, y, x);
+		printOps("cpDoubleMultiplyGenerator");
+	}
 	{
 		CurvePoint x = CurvePoint::G;
 		opsCount = 0;
@@ -254,6 +282,44 @@ static void doEcdsa() {
 		Ecdsa::verify(pubKey, msgHash, r, s);
 		printOps("edVerify");
 	}
+	{
+		Sha256Hash msgHash = Sha256::getHash(nullptr, 0);
+		Uint256 r, s;
+		int recId;
+		Ecdsa::signRecoverable(Uint256::ONE, msgHash, Uint256::ONE, r, s, recId);
+		CurvePoint pubKey = CurvePoint::ZERO;
+		opsCount = 0;
+		Ecdsa::recover(msgHash, r, s, recId, pubKey);
+		printOps("edRecover");
+		opsCount = 0;
+		Ecdsa::verify(pubKey, msgHash, r, s);
+		printOps("edVerify (same signature)");
+	}
+	{
+		PublicKey pubKey;
+		opsCount = 0;
+		pubKey.precompute();
+		printOps("pkPrecompute");
+		CurvePoint::doubleMultiplyPrecomputed(Uint256::ONE, Uint256::ONE, pubKey.getTable());  // Builds the shared table for G
+		Sha256Hash msgHash = Sha256::getHash(nullptr, 0);
+		Uint256 r = Uint256::ONE;
+		Uint256 s = Uint256::ONE;
+		opsCount = 0;
+		Ecdsa::verify(pubKey, msgHash, r, s);
+		printOps("edVerify (precomputed key)");
+	}
+	{
+		constexpr std::size_t n = 16;
+		const std::vector<CurvePoint> pubKeys(n, CurvePoint::G);
+		const std::vector<Sha256Hash> msgHashes(n, Sha256::getHash(nullptr, 0));
+		const std::vector<Uint256> rs(n, Uint256::ONE);
+		const std::vector<Uint256> ss(n, Uint256::ONE);
+		bool results[n];
+		opsCount = 0;
+		Ecdsa::verifyBatch(pubKeys.data(), msgHashes.data(), rs.data(), ss.data(), n, results);
+		opsCount /= n;
+		printOps("edVerifyBatch (per item)");
+	}
 	std::cout << std::endl;
 }
 
@@ -0,0 +1,50 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include <cassert>
+#include <cstdint>
+#include <type_traits>
+#include "Ecdsa.hpp"
+#include "EcdsaSigner.hpp"
+#include "Utils.hpp"
+
+using std::uint8_t;
+
+
+EcdsaSigner::EcdsaSigner(const Uint256 &privKey) :
+		privateKey(privKey),
+		publicKey(CurvePoint::privateExponentToPublicPoint(privKey)) {
+	uint8_t keyBytes[Uint256::NUM_WORDS * 4];
+	privateKey.getBigEndianBytes(keyBytes);
+	hmacInner = Sha256::getHmacKeyedHasher(keyBytes, sizeof(keyBytes), 0x36);
+	hmacOuter = Sha256::getHmacKeyedHasher(keyBytes, sizeof(keyBytes), 0x5C);
+	Utils::secureZero(keyBytes, sizeof(keyBytes));
+}
+
+
+EcdsaSigner::~EcdsaSigner() {
+	static_assert(std::is_trivially_copyable<Sha256>::value, "Must be overwritable as bytes");
+	Utils::secureZero(&privateKey, sizeof(privateKey));
+	Utils::secureZero(&hmacInner, sizeof(hmacInner));
+	Utils::secureZero(&hmacOuter, sizeof(hmacOuter));
+}
+
+
+const CurvePoint &EcdsaSigner::getPublicKey() const {
+	return publicKey;
+}
+
+
+bool EcdsaSigner::sign(const Sha256Hash &msgHash, Uint256 &outR, Uint256 &outS) const {
+	Sha256 inner = hmacInner;
+	const Sha256Hash innerHash = inner.append(msgHash.value, Sha256Hash::HASH_LEN).getHash();
+	Sha256 outer = hmacOuter;
+	const Sha256Hash hmac = outer.append(innerHash.value, Sha256Hash::HASH_LEN).getHash();
+	const Uint256 nonce(hmac.value);
+	return Ecdsa::sign(privateKey, msgHash, nonce, outR, outS);
+}
@@ -0,0 +1,62 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#pragma once
+
+#include "CurvePoint.hpp"
+#include "Sha256.hpp"
+#include "Sha256Hash.hpp"
+#include "Uint256.hpp"
+
+
+/* 
+ * Signs messages with one private key, keeping the per-key setup of Ecdsa::signWithHmacNonce() between calls.
+ * The HMAC-SHA-256 nonce derivation keys on the private key's bytes, so the hasher states after absorbing the
+ * padded inner and outer key blocks are computed once; each signature then only hashes the message and the inner
+ * digest from copies of those states. Signing does no heap allocation. Instances are immutable after construction,
+ * so one signer can be used from multiple threads. The object holds secret key material, which the destructor
+ * erases. Example usage:
+ *   const EcdsaSigner signer(privKey);
+ *   Uint256 r, s;
+ *   if (signer.sign(msgHash, r, s)) { ... }
+ */
+class EcdsaSigner final {
+	
+	/*---- Fields ----*/
+	
+	private: Uint256 privateKey;
+	private: CurvePoint publicKey;  // Normalized
+	private: Sha256 hmacInner;  // Has absorbed the big-endian private key XOR 0x36
+	private: Sha256 hmacOuter;  // Has absorbed the big-endian private key XOR 0x5C
+	
+	
+	
+	/*---- Constructors ----*/
+	
+	// Constructs a signer for the given private key, which must be in the range [1, CurvePoint::ORDER).
+	// Also computes the public key. Constant-time with respect to the private key.
+	public: explicit EcdsaSigner(const Uint256 &privKey);
+	
+	
+	// Zeroizes the private key and the HMAC states.
+	public: ~EcdsaSigner();
+	
+	
+	
+	/*---- Methods ----*/
+	
+	// Returns the normalized public key of this signer's private key.
+	public: const CurvePoint &getPublicKey() const;
+	
+	
+	// Signs the given message hash with the same nonce and result as Ecdsa::signWithHmacNonce() with this
+	// signer's private key. Returns true iff signing is successful (with overwhelming probability).
+	// This has the same constant-time behavior as Ecdsa::sign().
+	public: bool sign(const Sha256Hash &msgHash, Uint256 &outR, Uint256 &outS) const;
+	
+};
@@ -0,0 +1,78 @@
+/* 
+ * A runnable main program that tests the functionality of class EcdsaSigner.
+ * 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include "TestHelper.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "CurvePoint.hpp"
+#include "Ecdsa.hpp"
+#include "EcdsaSigner.hpp"
+#include "Sha256.hpp"
+#include "Sha256Hash.hpp"
+#include "Uint256.hpp"
+
+using std::uint8_t;
+
+
+// Global variables
+static int numTestCases = 0;
+
+
+/*---- Test cases ----*/
+
+static void testMatchesSignWithHmacNonce() {
+	const char *privKeys[] = {
+		"0000000000000000000000000000000000000000000000000000000000000001",
+		"00000000000000000000000000000000000000000000000000000000000000FF",
+		"C85AFBACCF3E1EE40BDCD721A9AD1341344775D51840EFC0511E0182AE92F78E",
+		"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364140",
+	};
+	const char *messages[] = {"", "abc", "Everything should be made as simple as possible, but not simpler."};
+	for (const char *hex : privKeys) {
+		const Uint256 privKey(hex);
+		const EcdsaSigner signer(privKey);
+		assert(signer.getPublicKey() == CurvePoint::privateExponentToPublicPoint(privKey));
+		assert(signer.getPublicKey().z == CurvePoint::FI_ONE);
+		for (const char *msg : messages) {
+			const Sha256Hash msgHash = Sha256::getHash(reinterpret_cast<const uint8_t *>(msg), std::strlen(msg));
+			Uint256 expectR, expectS;
+			assert(Ecdsa::signWithHmacNonce(privKey, msgHash, expectR, expectS));
+			Uint256 r, s;
+			assert(signer.sign(msgHash, r, s));
+			assert(r == expectR && s == expectS);
+			assert(Ecdsa::verify(signer.getPublicKey(), msgHash, r, s));
+			numTestCases++;
+		}
+	}
+}
+
+
+static void testRepeatedSigning() {
+	// The cached hasher states must not be consumed by signing
+	const EcdsaSigner signer(Uint256("2D8F0B4E6A1C3957F2E4B6D8A0C2E4F6183A5C7E9B1D3F5A7C9E1B3D5F7A9C1E"));
+	const Sha256Hash msgHash = Sha256::getHash(reinterpret_cast<const uint8_t *>("repeat"), 6);
+	Uint256 r0, s0;
+	assert(signer.sign(msgHash, r0, s0));
+	for (int i = 0; i < 3; i++) {
+		Uint256 r, s;
+		assert(signer.sign(msgHash, r, s));
+		assert(r == r0 && s == s0);
+		numTestCases++;
+	}
+}
+
+
+int main() {
+	testMatchesSignWithHmacNonce();
+	testRepeatedSigning();
+	std::printf("All %d test cases passed\n", numTestCases);
+	return EXIT_SUCCESS;
+}
@@ -11,10 +11,17 @@
 #include "TestHelper.hpp"
 #include <cstdio>
 #include <cstdlib>
+#include "CurvePoint.hpp"
 #include "Ecdsa.hpp"
+#include "FieldInt.hpp"
+#include "PublicKey.hpp"
+#include "Sha256.hpp"
 #include "Sha256Hash.hpp"
 #include "Uint256.hpp"
 
+using std::uint8_t;
+using std::uint64_t;
+
 
 // Global variables
 static int numTestCases = 0;
@@ -1803,14 +1810,241 @@ static void testEcdsaVerify() {
 		Uint256 r(tc.rValue);
 		Uint256 s(tc.sValue);
 		assert(Ecdsa::verify(publicKey, msgHash, r, s) == tc.answer);
+		PublicKey key;
+		if (PublicKey::fromPoint(publicKey, key)) {
+			assert(Ecdsa::verify(key, msgHash, r, s) == tc.answer);
+			key.precompute();
+			assert(Ecdsa::verify(key, msgHash, r, s) == tc.answer);
+		} else
+			assert(!tc.answer);
+		numTestCases++;
+	}
+	
+	// Verify the same cases in batches of various lengths
+	vector<CurvePoint> publicKeys;
+	vector<Sha256Hash> msgHashes;
+	vector<Uint256> rs;
+	vector<Uint256> ss;
+	for (const VerifyCase &tc : cases) {
+		publicKeys.push_back(CurvePoint(tc.pubPointX, tc.pubPointY));
+		msgHashes.push_back(Sha256Hash(tc.msgHash));
+		rs.push_back(Uint256(tc.rValue));
+		ss.push_back(Uint256(tc.sValue));
+	}
+	bool results[300];
+	for (size_t start = 0, len = 0; start < cases.size(); start += len, len = len * 2 % 299 + 1) {
+		if (len > cases.size() - start)
+			len = cases.size() - start;
+		Ecdsa::verifyBatch(&publicKeys[start], &msgHashes[start], &rs[start], &ss[start], len, results);
+		for (size_t i = 0; i < len; i++)
+			assert(results[i] == cases[start + i].answer);
+		numTestCases++;
+	}
+}
+
+
+static void testEcdsaSignBatch() {
+	// Deterministic mix of keys, hashes, and nonces, including invalid nonces
+	const size_t n = 150;
+	vector<Uint256> privateKeys;
+	vector<Sha256Hash> msgHashes;
+	vector<Uint256> nonces;
+	Uint256 x("0000000000000000000000000000000000000000000000000000000000000123");
+	const Uint256 step("9E3779B97F4A7C15F39CC0605CEDC8341082276BF3A27251F86C6A11D0C18E95");
+	for (size_t i = 0; i < n; i++) {
+		x.add(step);
+		x.subtract(CurvePoint::ORDER, static_cast<std::uint32_t>(x >= CurvePoint::ORDER));
+		privateKeys.push_back(x);
+		uint8_t hashBytes[Sha256Hash::HASH_LEN];
+		x.getBigEndianBytes(hashBytes);
+		hashBytes[0] ^= static_cast<uint8_t>(i);
+		msgHashes.push_back(Sha256Hash(hashBytes, Sha256Hash::HASH_LEN));
+		Uint256 nonce = x;
+		nonce.add(x);
+		nonce.subtract(CurvePoint::ORDER, static_cast<std::uint32_t>(nonce >= CurvePoint::ORDER));
+		nonces.push_back(nonce);
+	}
+	nonces[3] = Uint256::ZERO;
+	nonces[70] = CurvePoint::ORDER;
+	nonces[71] = Uint256("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFF");
+	nonces[72] = Uint256::ONE;
+	
+	vector<Uint256> rs(n), ss(n);
+	bool results[n];
+	for (int useNonces = 0; useNonces < 2; useNonces++) {
+		const Uint256 *batchNonces = useNonces != 0 ? nonces.data() : nullptr;
+		for (size_t start = 0, len = 0; start < n; start += len, len = len * 3 % 97 + 1) {
+			if (len > n - start)
+				len = n - start;
+			Ecdsa::signBatch(&privateKeys[start], &msgHashes[start], batchNonces != nullptr ? &batchNonces[start] : nullptr,
+				len, &rs[start], &ss[start], &results[start]);
+		}
+		for (size_t i = 0; i < n; i++) {
+			Uint256 r, s;
+			bool ok = batchNonces != nullptr ?
+				Ecdsa::sign(privateKeys[i], msgHashes[i], nonces[i], r, s) :
+				Ecdsa::signWithHmacNonce(privateKeys[i], msgHashes[i], r, s);
+			assert(results[i] == ok);
+			if (ok)
+				assert(rs[i] == r && ss[i] == s);
+			numTestCases++;
+		}
+	}
+	assert(!results[3] && !results[70] && !results[71] && results[72]);
+}
+
+
+static void testSignRecoverable() {
+	const char *privKeys[] = {
+		"0000000000000000000000000000000000000000000000000000000000000001",
+		"C85AFBACCF3E1EE40BDCD721A9AD1341344775D51840EFC0511E0182AE92F78E",
+		"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364140",
+	};
+	for (const char *hex : privKeys) {
+		const Uint256 privateKey(hex);
+		const CurvePoint publicKey = CurvePoint::privateExponentToPublicPoint(privateKey);
+		for (int i = 0; i < 8; i++) {
+			uint8_t msg[2] = {static_cast<uint8_t>(i), 0x5A};
+			const Sha256Hash msgHash = Sha256::getHash(msg, sizeof(msg));
+			Uint256 nonce(Sha256::getHash(msg, 1).value);
+			nonce.subtract(CurvePoint::ORDER, static_cast<std::uint32_t>(nonce >= CurvePoint::ORDER));
+			Uint256 r, s, r0, s0;
+			int recId = -1;
+			assert(Ecdsa::signRecoverable(privateKey, msgHash, nonce, r, s, recId));
+			assert(Ecdsa::sign(privateKey, msgHash, nonce, r0, s0) && r == r0 && s == s0);
+			assert(0 <= recId && recId < 4);
+			
+			CurvePoint recovered = CurvePoint::G;
+			assert(Ecdsa::recover(msgHash, r, s, recId, recovered));
+			assert(recovered.x == publicKey.x && recovered.y == publicKey.y && recovered.z == publicKey.z);
+			for (int other = 0; other < 4; other++) {
+				CurvePoint q = CurvePoint::G;
+				if (other != recId && Ecdsa::recover(msgHash, r, s, other, q)) {
+					assert(q != publicKey);
+					assert(Ecdsa::verify(q, msgHash, r, s));
+				}
+			}
+			
+			uint8_t compact[Ecdsa::COMPACT_SIGNATURE_LEN];
+			Ecdsa::toCompactSignature(r, s, recId, true, compact);
+			assert(compact[0] == 31 + recId);
+			Uint256 r1, s1;
+			int recId1;
+			bool compressed;
+			assert(Ecdsa::fromCompactSignature(compact, r1, s1, recId1, compressed));
+			assert(r1 == r && s1 == s && recId1 == recId && compressed);
+			numTestCases++;
+		}
+	}
+	
+	// Invalid inputs
+	const Sha256Hash msgHash = Sha256::getHash(nullptr, 0);
+	CurvePoint q = CurvePoint::G;
+	assert(!Ecdsa::recover(msgHash, Uint256::ZERO, Uint256::ONE, 0, q));
+	assert(!Ecdsa::recover(msgHash, Uint256::ONE, CurvePoint::ORDER, 0, q));
+	assert(!Ecdsa::recover(msgHash, Uint256::ONE, Uint256::ONE, 4, q));
+	assert(!Ecdsa::recover(msgHash, Uint256("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364140"), Uint256::ONE, 2, q));  // x >= modulus
+	assert(q == CurvePoint::G);
+	uint8_t compact[Ecdsa::COMPACT_SIGNATURE_LEN] = {27};
+	Uint256 r, s;
+	int recId;
+	bool compressed;
+	assert(!Ecdsa::fromCompactSignature(compact, r, s, recId, compressed));  // Zero r and s
+	compact[32] = 1;
+	compact[64] = 1;
+	assert(Ecdsa::fromCompactSignature(compact, r, s, recId, compressed) && recId == 0 && !compressed);
+	compact[0] = 35;
+	assert(!Ecdsa::fromCompactSignature(compact, r, s, recId, compressed));
+	numTestCases++;
+}
+
+
+static void testVerifyDetailed() {
+	const Sha256Hash msgHash = Sha256::getHash(nullptr, 0);
+	Uint256 r, s;
+	assert(Ecdsa::signWithHmacNonce(Uint256::ONE, msgHash, r, s));
+	Uint256 highS = CurvePoint::ORDER;
+	highS.subtract(s);
+	Uint256 otherR = r;
+	otherR.add(Uint256::ONE);
+	CurvePoint notNormalized = CurvePoint::G;
+	notNormalized.twice();
+	FieldInt y = CurvePoint::G.y;
+	y.add(FieldInt("0000000000000000000000000000000000000000000000000000000000000002"));
+	const CurvePoint offCurve(CurvePoint::G.x, y);
+	
+	struct Case {
+		const CurvePoint &publicKey;
+		const Uint256 &r;
+		const Uint256 &s;
+		bool requireLowS;
+		Ecdsa::VerifyResult expected;
+	};
+	const Case cases[] = {
+		{CurvePoint::G, r, s, true, Ecdsa::VERIFY_VALID},
+		{CurvePoint::G, r, highS, false, Ecdsa::VERIFY_VALID},
+		{CurvePoint::G, r, highS, true, Ecdsa::VERIFY_HIGH_S},
+		{CurvePoint::G, Uint256::ZERO, s, true, Ecdsa::VERIFY_BAD_R},
+		{CurvePoint::G, CurvePoint::ORDER, CurvePoint::ORDER, true, Ecdsa::VERIFY_BAD_R},  // First failure wins
+		{CurvePoint::G, r, Uint256::ZERO, false, Ecdsa::VERIFY_BAD_S},
+		{CurvePoint::G, r, CurvePoint::ORDER, true, Ecdsa::VERIFY_BAD_S},
+		{CurvePoint::ZERO, r, s, false, Ecdsa::VERIFY_BAD_PUBLIC_KEY},
+		{notNormalized, r, s, false, Ecdsa::VERIFY_BAD_PUBLIC_KEY},
+		{offCurve, r, s, false, Ecdsa::VERIFY_BAD_PUBLIC_KEY},
+		{offCurve, r, highS, true, Ecdsa::VERIFY_HIGH_S},
+		{CurvePoint::G, otherR, s, true, Ecdsa::VERIFY_MISMATCH},
+	};
+	Ecdsa::resetVerifyResultCounts();
+	uint64_t expectedCounts[Ecdsa::NUM_VERIFY_RESULTS] = {};
+	for (const Case &tc : cases) {
+		assert(Ecdsa::verifyDetailed(tc.publicKey, msgHash, tc.r, tc.s, tc.requireLowS) == tc.expected);
+		expectedCounts[tc.expected]++;
+		if (!tc.requireLowS) {
+			assert(Ecdsa::verify(tc.publicKey, msgHash, tc.r, tc.s) == (tc.expected == Ecdsa::VERIFY_VALID));
+			expectedCounts[tc.expected]++;
+		}
 		numTestCases++;
 	}
+	for (int i = 0; i < Ecdsa::NUM_VERIFY_RESULTS; i++)
+		assert(Ecdsa::getVerifyResultCount(static_cast<Ecdsa::VerifyResult>(i)) == expectedCounts[i]);
+	
+	// Encoded public keys
+	uint8_t compressed[33], uncompressed[65];
+	CurvePoint::G.toCompressedPoint(compressed);
+	CurvePoint::G.toUncompressedPoint(uncompressed);
+	assert(Ecdsa::verifyDetailed(compressed, sizeof(compressed), msgHash, r, s, true) == Ecdsa::VERIFY_VALID);
+	assert(Ecdsa::verifyDetailed(uncompressed, sizeof(uncompressed), msgHash, r, s, true) == Ecdsa::VERIFY_VALID);
+	assert(Ecdsa::verifyDetailed(compressed, sizeof(compressed), msgHash, otherR, s, true) == Ecdsa::VERIFY_MISMATCH);
+	assert(Ecdsa::verifyDetailed(compressed, sizeof(compressed) - 1, msgHash, r, s, true) == Ecdsa::VERIFY_BAD_PUBLIC_KEY);
+	assert(Ecdsa::verifyDetailed(compressed, sizeof(compressed) - 1, msgHash, r, highS, true) == Ecdsa::VERIFY_HIGH_S);
+	uncompressed[64] ^= 1;
+	assert(Ecdsa::verifyDetailed(uncompressed, sizeof(uncompressed), msgHash, r, s, false) == Ecdsa::VERIFY_BAD_PUBLIC_KEY);
+	numTestCases++;
+	
+	// Batches count each item
+	Ecdsa::resetVerifyResultCounts();
+	const CurvePoint pubKeys[] = {CurvePoint::G, CurvePoint::G, CurvePoint::G, offCurve};
+	const Sha256Hash msgHashes[] = {msgHash, msgHash, msgHash, msgHash};
+	const Uint256 rs[] = {r, otherR, Uint256::ZERO, r};
+	const Uint256 ss[] = {highS, s, s, s};
+	bool results[4];
+	Ecdsa::verifyBatch(pubKeys, msgHashes, rs, ss, 4, results);
+	assert(results[0] && !results[1] && !results[2] && !results[3]);
+	assert(Ecdsa::getVerifyResultCount(Ecdsa::VERIFY_VALID) == 1);
+	assert(Ecdsa::getVerifyResultCount(Ecdsa::VERIFY_MISMATCH) == 1);
+	assert(Ecdsa::getVerifyResultCount(Ecdsa::VERIFY_BAD_R) == 1);
+	assert(Ecdsa::getVerifyResultCount(Ecdsa::VERIFY_BAD_PUBLIC_KEY) == 1);
+	assert(Ecdsa::getVerifyResultCount(Ecdsa::VERIFY_HIGH_S) == 0);
+	numTestCases++;
 }
 
 
 int main() {
 	testEcdsaSignAndVerify();
 	testEcdsaVerify();
+	testEcdsaSignBatch();
+	testSignRecoverable();
+	testVerifyDetailed();
 	std::printf("All %d test cases passed\n", numTestCases);
 	return EXIT_SUCCESS;
 }
@@ -210,6 +210,76 @@ void FieldInt::reciprocal() {
 }
 
 
+bool FieldInt::sqrt() {
+	/* 
+	 * The exponent (MODULUS + 1) / 4 in binary is 223 ones, 0, 22 ones, 0000, 11, 00.
+	 * Algorithm pseudocode, where xk = this^(2^k - 1):
+	 * x2 = x1^2 * x1, x3 = x2^2 * x1, x6 = x3^(2^3) * x3, x9 = x6^(2^3) * x3,
+	 * x11 = x9^(2^2) * x2, x22 = x11^(2^11) * x11, x44 = x22^(2^22) * x22,
+	 * x88 = x44^(2^44) * x44, x176 = x88^(2^88) * x88, x220 = x176^(2^44) * x44,
+	 * x223 = x220^(2^3) * x3
+	 * result = ((x223^(2^23) * x22)^(2^6) * x2)^(2^2)
+	 */
+	countOps(functionOps);
+	const FieldInt x1 = *this;
+	FieldInt x2 = x1;
+	x2.square();
+	x2.multiply(x1);
+	FieldInt x3 = x2;
+	x3.square();
+	x3.multiply(x1);
+	FieldInt x6 = x3;
+	x6.squareRepeat(3);
+	x6.multiply(x3);
+	FieldInt x9 = x6;
+	x9.squareRepeat(3);
+	x9.multiply(x3);
+	FieldInt x11 = x9;
+	x11.squareRepeat(2);
+	x11.multiply(x2);
+	FieldInt x22 = x11;
+	x22.squareRepeat(11);
+	x22.multiply(x11);
+	FieldInt x44 = x22;
+	x44.squareRepeat(22);
+	x44.multiply(x22);
+	FieldInt x88 = x44;
+	x88.squareRepeat(44);
+	x88.multiply(x44);
+	FieldInt x176 = x88;
+	x176.squareRepeat(88);
+	x176.multiply(x88);
+	FieldInt x220 = x176;
+	x220.squareRepeat(44);
+	x220.multiply(x44);
+	FieldInt x223 = x220;
+	x223.squareRepeat(3);
+	x223.multiply(x3);
+	
+	*this = x223;
+	squareRepeat(23);
+	multiply(x22);
+	squareRepeat(6);
+	multiply(x2);
+	squareRepeat(2);
+	countOps(13 * fieldintCopyOps);
+	
+	FieldInt check = *this;
+	check.square();
+	countOps(1 * fieldintCopyOps);
+	return check == x1;
+}
+
+
+void FieldInt::squareRepeat(int count) {
+	countOps(functionOps);
+	for (int i = 0; i < count; i++) {
+		countOps(loopBodyOps);
+		square();
+	}
+}
+
+
 void FieldInt::replace(const FieldInt &other, uint32_t enable) {
 	countOps(functionOps);
 	Uint256::replace(other, enable);
@@ -71,6 +71,16 @@ class FieldInt final : private Uint256 {
 	public: void reciprocal();
 	
 	
+	// Sets this number to this^((MODULUS + 1) / 4), and returns whether the result is a square root of the original value
+	// (true iff the original value is a quadratic residue or zero). Uses a fixed addition chain of 253 squarings and
+	// 13 multiplications. Constant-time with respect to this value.
+	public: bool sqrt();
+	
+	
+	// Squares this number the given number of times. Constant-time with respect to this value.
+	private: void squareRepeat(int count);
+	
+	
 	/*---- Miscellaneous methods ----*/
 	
 	public: void replace(const FieldInt &other, std::uint32_t enable);
@@ -272,6 +272,42 @@ static void testReciprocal() {
 }
 
 
+static void testSqrt() {
+	const vector<BinaryCase> cases{  // y is null if x has no square root
+		{"0000000000000000000000000000000000000000000000000000000000000000", "0000000000000000000000000000000000000000000000000000000000000000"},
+		{"0000000000000000000000000000000000000000000000000000000000000001", "0000000000000000000000000000000000000000000000000000000000000001"},
+		{"0000000000000000000000000000000000000000000000000000000000000002", "210C790573632359B1EDB4302C117D8A132654692C3FEEB7DE3A86AC3F3B53F7"},
+		{"0000000000000000000000000000000000000000000000000000000000000003", nullptr},
+		{"0000000000000000000000000000000000000000000000000000000000000004", "0000000000000000000000000000000000000000000000000000000000000002"},
+		{"0000000000000000000000000000000000000000000000000000000000000007", nullptr},
+		{"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFC2E", nullptr},
+		{"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEFFFFFC2D", nullptr},
+		{"7A9D969146FC8893D73C43FAD1272A253BB427C1A1DA059D2AD1245C92010B38", nullptr},
+		{"FAAEDB9E2FBF496887011B4EE8A8FC75885D6F33E40C2FC4E158FB57A6E04B64", "38FEFCBD4CD9C5DDFD571AC5CA8C862F6C3FC436BC31EFA7B346E0C1CFFB7F78"},
+		{"AFE0F19AF758BFE8522CBE7B80DE6B34F189AA6F9DFB65DCE7BB3348A6D7967B", "69E1C4ACE227403CFD7513028B0AF8B07B29629D7EA6EA0E9E9E8898FBE02138"},
+		{"121E2576A2B7FB29AC445DA3F18D394C483E8EF571FC2C397B20872A873C7488", nullptr},
+		{"BE3AC93D0D7710A3E61B6AA07F00725A84AB7CCB4F2BA00C69ECC7624D21A23B", nullptr},
+		{"47CDAD4FD8B9FB81D0B384FE6D17A135AD5EA460BC60F7BADC1E980D9B8A7945", nullptr},
+		{"DD546C921E04932B3EE0E132AE6D1FC1C3C75DE08E3C52ED51C83CC9ED906531", nullptr},
+		{"FD921AFE369EF033FEC612F348D11107E33D4470FAE2BFDD51BE78090E574C27", "C17F67CAA3EB32BF5F9C9338389A6CA4E7A629C0F70029853172F38BE22D0F79"},
+		{"C50263CE52590A3CA74C860B1F88E9975DA83437BFF425B110F45208E58B98E9", "39B0918C0B3D4A59CFE8B87A074382BA0DD1B6B363358061EB97B932E91895FE"},
+		{"A893A8B88651AAA95A975C6301A1A74251F28F0845D00E57834670013E202905", nullptr},
+		{"8A5C93BC9C68F317AA0A64CF266681844FF4D6B0397B4D2C0E4BDF859C2441E3", "1EED98FDE3D17A015005D39CD087419B9C67B8349B15176D71E86EB5B21696A5"},
+		{"DD854D59C6F8E5AE6807EC20B1FCB12F1C12B52D9CCB9892DC0F424686049AD7", "25DF421970BAA696512B261340AC61FE5F6219242093198AA2AAFCE0F792E44C"},
+		{"6C54FA5B4F96947D968768424DCFB5A78297F4D35125348A33215CA5FDDE3316", "00C727EF51099AB4CEE39A6A1EA1902917E03AFC26218FFD1035F5B41FB41A07"},
+		{"7249D87FCCB0E85C8BA70EDC4FC7B839B96969CD922B9FECD8836C86A4EA1EB7", "AD41E3DC315DDB1CDDF8F81033F0E92C592189B24680E53568F524D90EBEAEDF"},
+	};
+	for (const BinaryCase &tc : cases) {
+		FieldInt x(tc.x);
+		bool ok = x.sqrt();
+		assert(ok == (tc.y != nullptr));
+		if (ok)
+			assert(x == FieldInt(tc.y));
+		numTestCases++;
+	}
+}
+
+
 static void testConstructorUint256() {
 	const vector<BinaryCase> cases{
 		{"0000000000000000000000000000000000000000000000000000000000000000", "0000000000000000000000000000000000000000000000000000000000000000"},
@@ -365,6 +401,7 @@ int main() {
 	testMultiply();
 	testSquare();
 	testReciprocal();
+	testSqrt();
 	testConstructorUint256();
 	if (USE_X8664_ASM_IMPL) {
 		testAsmMultiply256x256eq512();
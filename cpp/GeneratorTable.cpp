@@ -0,0 +1,136 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include <cassert>
+#include <cstdio>
+#include <cstring>
+#include <vector>
+#include "GeneratorTable.hpp"
+#include "Sha256.hpp"
+#include "Sha256Hash.hpp"
+
+#if defined(__unix__) || defined(__APPLE__)
+	#define GENERATOR_TABLE_MMAP 1
+	#include <fcntl.h>
+	#include <sys/mman.h>
+	#include <sys/stat.h>
+	#include <unistd.h>
+#else
+	#define GENERATOR_TABLE_MMAP 0
+#endif
+
+using std::size_t;
+using std::uint8_t;
+using std::uint32_t;
+
+
+GeneratorTable::GeneratorTable() :
+	points(nullptr),
+	mapping(nullptr) {}
+
+
+GeneratorTable::~GeneratorTable() {
+	unload();
+}
+
+
+bool GeneratorTable::load(const char *path) {
+	assert(path != nullptr);
+	unload();
+#if GENERATOR_TABLE_MMAP
+	int fd = open(path, O_RDONLY);
+	if (fd == -1)
+		return false;
+	struct stat st;
+	void *map = MAP_FAILED;
+	if (fstat(fd, &st) == 0 && static_cast<size_t>(st.st_size) == FILE_LEN)
+		map = mmap(nullptr, FILE_LEN, PROT_READ, MAP_SHARED, fd, 0);
+	close(fd);  // The mapping stays valid
+	if (map == MAP_FAILED)
+		return false;
+	
+	const uint8_t *bytes = static_cast<const uint8_t *>(map);
+	const CurvePoint *entries = reinterpret_cast<const CurvePoint *>(&bytes[HEADER_LEN]);
+	uint8_t expect[HEADER_LEN];
+	makeHeader(entries, expect);
+	if (std::memcmp(bytes, expect, HEADER_LEN) != 0) {
+		munmap(map, FILE_LEN);
+		return false;
+	}
+	mapping = map;
+	points = entries;
+	return true;
+#else
+	return false;
+#endif
+}
+
+
+void GeneratorTable::unload() {
+#if GENERATOR_TABLE_MMAP
+	if (mapping != nullptr)
+		munmap(mapping, FILE_LEN);
+#endif
+	mapping = nullptr;
+	points = nullptr;
+}
+
+
+bool GeneratorTable::isLoaded() const {
+	return points != nullptr;
+}
+
+
+const CurvePoint *GeneratorTable::getPoints() const {
+	return points;
+}
+
+
+bool GeneratorTable::verifyContents() const {
+	if (points == nullptr)
+		return false;
+	std::vector<CurvePoint> expect(CurvePoint::GENERATOR_TABLE_LEN, CurvePoint::ZERO);
+	CurvePoint::precomputeGeneratorTable(expect.data());
+	return std::memcmp(points, expect.data(), expect.size() * sizeof(CurvePoint)) == 0;
+}
+
+
+bool GeneratorTable::writeFile(const char *path) {
+	assert(path != nullptr);
+	std::vector<CurvePoint> entries(CurvePoint::GENERATOR_TABLE_LEN, CurvePoint::ZERO);
+	CurvePoint::precomputeGeneratorTable(entries.data());
+	uint8_t header[HEADER_LEN];
+	makeHeader(entries.data(), header);
+	
+	std::FILE *f = std::fopen(path, "wb");
+	if (f == nullptr)
+		return false;
+	size_t entriesLen = entries.size() * sizeof(CurvePoint);
+	bool ok = std::fwrite(header, 1, HEADER_LEN, f) == HEADER_LEN
+		&& std::fwrite(entries.data(), 1, entriesLen, f) == entriesLen;
+	ok &= std::fclose(f) == 0;
+	return ok;
+}
+
+
+void GeneratorTable::makeHeader(const CurvePoint entries[CurvePoint::GENERATOR_TABLE_LEN], uint8_t header[HEADER_LEN]) {
+	static_assert(HEADER_LEN % 32 == 0, "Entries must stay aligned");
+	std::memset(header, 0, HEADER_LEN);
+	std::memcpy(&header[0], "SECPGTAB", 8);
+	const uint32_t fields[] = {
+		VERSION,
+		static_cast<uint32_t>(CurvePoint::GENERATOR_TABLE_WINDOW),
+		static_cast<uint32_t>(CurvePoint::GENERATOR_TABLE_LEN),
+		static_cast<uint32_t>(sizeof(CurvePoint)),
+		UINT32_C(0x01020304),
+	};
+	std::memcpy(&header[8], fields, sizeof(fields));
+	Sha256Hash hash = Sha256::getHash(reinterpret_cast<const uint8_t *>(entries),
+		CurvePoint::GENERATOR_TABLE_LEN * sizeof(CurvePoint));
+	std::memcpy(&header[HEADER_LEN - Sha256Hash::HASH_LEN], hash.value, Sha256Hash::HASH_LEN);
+}
@@ -0,0 +1,105 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "CurvePoint.hpp"
+
+
+/* 
+ * A file holding CurvePoint's precomputed generator table, mapped into memory read-only. This keeps the large
+ * table out of the binary and avoids recomputing it at startup, and the operating system shares its pages
+ * between all processes that map the same file. The file format is a 64-byte header followed by the entries:
+ * - Magic "SECPGTAB" (8 bytes), then the 32-bit version, window width, number of entries,
+ *   sizeof(CurvePoint), and byte order mark 0x01020304, then 4 zero bytes, all in native byte order.
+ * - The SHA-256 hash of the entry data (32 bytes).
+ * - The entries of CurvePoint::precomputeGeneratorTable() as raw CurvePoint objects, 32-byte aligned.
+ * A file is only usable on a platform with the same byte order and CurvePoint layout. The checksum detects
+ * corruption but not deliberate tampering, so the file must come from a trusted source (or be checked
+ * once with verifyContents()). Instances are not copyable. Example usage:
+ *   GeneratorTable table;
+ *   if (table.load("secp256k1-g.tab"))
+ *     CurvePoint::setGeneratorTable(table.getPoints());  // Otherwise the built-in method is used
+ */
+class GeneratorTable final {
+	
+	/*---- Public constants ----*/
+	
+	public: static constexpr std::size_t HEADER_LEN = 64;
+	public: static constexpr std::size_t FILE_LEN = HEADER_LEN + CurvePoint::GENERATOR_TABLE_LEN * sizeof(CurvePoint);
+	
+	
+	
+	/*---- Fields ----*/
+	
+	private: const CurvePoint *points;  // Null if not loaded, otherwise inside the mapping
+	private: void *mapping;
+	
+	
+	
+	/*---- Constructors ----*/
+	
+	// Constructs an object with no table loaded.
+	public: explicit GeneratorTable();
+	
+	
+	// Unmaps the file, if loaded. The table must not be installed in CurvePoint at this point.
+	public: ~GeneratorTable();
+	
+	
+	public: GeneratorTable(const GeneratorTable &other) = delete;
+	
+	public: GeneratorTable &operator=(const GeneratorTable &other) = delete;
+	
+	
+	
+	/*---- Methods ----*/
+	
+	// Unloads any current table, then maps the file at the given path and checks its length, header, and
+	// checksum. Returns true if the table is now loaded; otherwise (including when the file is missing
+	// or memory mapping is unsupported on this platform) returns false and leaves nothing loaded.
+	public: bool load(const char *path);
+	
+	
+	// Unmaps the file, if loaded. The table must not be installed in CurvePoint at this point.
+	public: void unload();
+	
+	
+	// Returns whether a table is loaded.
+	public: bool isLoaded() const;
+	
+	
+	// Returns the loaded table of CurvePoint::GENERATOR_TABLE_LEN entries, or null if none is loaded.
+	public: const CurvePoint *getPoints() const;
+	
+	
+	// Returns whether a table is loaded and every entry equals the freshly computed value. This takes about as
+	// long as writeFile(), so it is meant for one-time checks of a file's provenance. Not constant-time.
+	public: bool verifyContents() const;
+	
+	
+	
+	/*---- Static functions ----*/
+	
+	// Computes the table and writes it in this class's format to the given path, replacing any
+	// existing file. Returns whether the whole file was written successfully. Not constant-time.
+	public: static bool writeFile(const char *path);
+	
+	
+	// Fills in the header for the given entry data, including its checksum.
+	private: static void makeHeader(const CurvePoint entries[CurvePoint::GENERATOR_TABLE_LEN], std::uint8_t header[HEADER_LEN]);
+	
+	
+	
+	/*---- Class constants ----*/
+	
+	private: static constexpr std::uint32_t VERSION = 1;
+	
+};
@@ -0,0 +1,149 @@
+/* 
+ * A runnable main program that tests the functionality of class GeneratorTable.
+ * 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include "TestHelper.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "CurvePoint.hpp"
+#include "Ecdsa.hpp"
+#include "GeneratorTable.hpp"
+#include "Sha256.hpp"
+#include "Sha256Hash.hpp"
+#include "Uint256.hpp"
+
+using std::uint8_t;
+
+
+// Global variables
+static int numTestCases = 0;
+static const char *TEMP_PATH = "GeneratorTableTest.tmp";
+
+
+/*---- Helper functions ----*/
+
+static Bytes readFile(const char *path) {
+	Bytes result;
+	std::FILE *f = std::fopen(path, "rb");
+	assert(f != nullptr);
+	for (int c; (c = std::fgetc(f)) != EOF; )
+		result.push_back(static_cast<uint8_t>(c));
+	std::fclose(f);
+	return result;
+}
+
+
+static void writeBytes(const char *path, const Bytes &data) {
+	std::FILE *f = std::fopen(path, "wb");
+	assert(f != nullptr);
+	assert(std::fwrite(data.data(), 1, data.size(), f) == data.size());
+	std::fclose(f);
+}
+
+
+/*---- Test cases ----*/
+
+static void testWriteAndLoad() {
+	GeneratorTable table;
+	assert(!table.isLoaded() && table.getPoints() == nullptr && !table.verifyContents());
+	assert(GeneratorTable::writeFile(TEMP_PATH));
+	Bytes data = readFile(TEMP_PATH);
+	assert(data.size() == GeneratorTable::FILE_LEN);
+	assert(std::memcmp(data.data(), "SECPGTAB", 8) == 0);
+	numTestCases++;
+	
+	assert(table.load(TEMP_PATH) && table.isLoaded() && table.verifyContents());
+	const CurvePoint *points = table.getPoints();
+	assert(reinterpret_cast<std::uintptr_t>(points) % 32 == 0);
+	assert(points[0] == CurvePoint::G && points[0].z == CurvePoint::FI_ONE);
+	CurvePoint g2 = CurvePoint::G;
+	g2.twice();
+	assert(points[1] == g2);
+	numTestCases++;
+	
+	table.unload();
+	assert(!table.isLoaded() && table.getPoints() == nullptr);
+	numTestCases++;
+}
+
+
+static void testRejectInvalidFiles() {
+	GeneratorTable table;
+	assert(!table.load("GeneratorTableTest-missing.tmp") && !table.isLoaded());
+	numTestCases++;
+	
+	assert(GeneratorTable::writeFile(TEMP_PATH));
+	const Bytes good = readFile(TEMP_PATH);
+	const size_t offsets[] = {0, 8, 20, 40, GeneratorTable::HEADER_LEN, GeneratorTable::HEADER_LEN + 1000, good.size() - 1};
+	for (size_t off : offsets) {
+		Bytes bad = good;
+		bad.at(off) ^= 0x10;
+		writeBytes(TEMP_PATH, bad);
+		assert(!table.load(TEMP_PATH) && !table.isLoaded());
+		numTestCases++;
+	}
+	
+	Bytes truncated(good.begin(), good.end() - 1);
+	writeBytes(TEMP_PATH, truncated);
+	assert(!table.load(TEMP_PATH));
+	Bytes extended = good;
+	extended.push_back(0);
+	writeBytes(TEMP_PATH, extended);
+	assert(!table.load(TEMP_PATH));
+	numTestCases++;
+	
+	// A failed load unloads the previous table
+	writeBytes(TEMP_PATH, good);
+	assert(table.load(TEMP_PATH));
+	writeBytes(TEMP_PATH, truncated);
+	assert(!table.load(TEMP_PATH) && !table.isLoaded());
+	numTestCases++;
+}
+
+
+static void testInstalled() {
+	assert(GeneratorTable::writeFile(TEMP_PATH));
+	GeneratorTable table;
+	assert(table.load(TEMP_PATH));
+	
+	const char *privKeys[] = {
+		"0000000000000000000000000000000000000000000000000000000000000001",
+		"00000000000000000000000000000000000000000000000000000000000000FF",
+		"7F3B2A1C0D9E8F7A6B5C4D3E2F1A0B9C8D7E6F5A4B3C2D1E0F9A8B7C6D5E4F3A",
+		"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364140",
+	};
+	for (const char *hex : privKeys) {
+		const Uint256 privKey(hex);
+		const CurvePoint expectPub = CurvePoint::privateExponentToPublicPoint(privKey);
+		const Sha256Hash msgHash = Sha256::getHash(reinterpret_cast<const uint8_t *>(hex), std::strlen(hex));
+		Uint256 expectR, expectS;
+		assert(Ecdsa::signWithHmacNonce(privKey, msgHash, expectR, expectS));
+		
+		CurvePoint::setGeneratorTable(table.getPoints());
+		const CurvePoint pub = CurvePoint::privateExponentToPublicPoint(privKey);
+		Uint256 r, s;
+		assert(Ecdsa::signWithHmacNonce(privKey, msgHash, r, s));
+		CurvePoint::setGeneratorTable(nullptr);
+		
+		assert(pub.x == expectPub.x && pub.y == expectPub.y && pub.z == expectPub.z);
+		assert(r == expectR && s == expectS);
+		numTestCases++;
+	}
+}
+
+
+int main() {
+	testWriteAndLoad();
+	testRejectInvalidFiles();
+	testInstalled();
+	std::remove(TEMP_PATH);
+	std::printf("All %d test cases passed\n", numTestCases);
+	return EXIT_SUCCESS;
+}
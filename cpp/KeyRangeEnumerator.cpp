@@ -0,0 +1,94 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include <cassert>
+#include "Base58Check.hpp"
+#include "KeyRangeEnumerator.hpp"
+#include "Sha256.hpp"
+#include "Sha256Hash.hpp"
+
+using std::uint8_t;
+using std::uint32_t;
+using std::uint64_t;
+
+
+KeyRangeEnumerator::KeyRangeEnumerator(const Uint256 &start, uint64_t count) :
+		points(CHUNK_LEN),
+		step(CurvePoint::G),
+		nextKey(start) {
+	assert((Uint256::ZERO < start) & (start < CurvePoint::ORDER));
+	CurvePoint p = CurvePoint::multiplyGenerator(start);
+	for (int i = 0; i < CHUNK_LEN; i++) {
+		points.set(i, p);
+		p.add(CurvePoint::G);
+	}
+	static_assert((CHUNK_LEN & (CHUNK_LEN - 1)) == 0, "Step is computed by doubling");
+	for (int i = 1; i < CHUNK_LEN; i <<= 1)
+		step.twice();
+	
+	// remaining = min(count, ORDER - start), without branching on start
+	Uint256 available = CurvePoint::ORDER;
+	available.subtract(start);
+	uint32_t high = 0;
+	for (int i = 2; i < Uint256::NUM_WORDS; i++)
+		high |= available.value[i];
+	uint64_t available64 = static_cast<uint64_t>(available.value[1]) << 32 | available.value[0];
+	uint64_t useCount = 0 - static_cast<uint64_t>((high != 0) | (count < available64));
+	remaining = (count & useCount) | (available64 & ~useCount);
+}
+
+
+const Uint256 &KeyRangeEnumerator::getNextKey() const {
+	return nextKey;
+}
+
+
+uint64_t KeyRangeEnumerator::getRemaining() const {
+	return remaining;
+}
+
+
+int KeyRangeEnumerator::nextCompressedKeys(uint8_t out[CHUNK_LEN][33]) {
+	assert(out != nullptr);
+	int len = remaining < static_cast<uint64_t>(CHUNK_LEN) ? static_cast<int>(remaining) : CHUNK_LEN;
+	if (len == 0)
+		return 0;
+	
+	// Lanes past the end of a partial chunk may hold zero (at key ORDER) or wrap around, but are not emitted
+	points.normalize();  // Normalized points are still valid inputs to the next addition
+	for (int i = 0; i < len; i++)
+		points.get(i).toCompressedPoint(out[i]);
+	points.add(step);
+	Uint256 advance;
+	advance.value[0] = static_cast<uint32_t>(len);
+	nextKey.add(advance);
+	remaining -= static_cast<uint64_t>(len);
+	return len;
+}
+
+
+int KeyRangeEnumerator::nextPubkeyHashes(uint8_t out[CHUNK_LEN][Ripemd160::HASH_LEN]) {
+	assert(out != nullptr);
+	uint8_t keys[CHUNK_LEN][33];
+	int len = nextCompressedKeys(keys);
+	for (int i = 0; i < len; i++) {
+		Sha256Hash innerHash = Sha256::getHash(keys[i], sizeof(keys[i]));
+		Ripemd160::getHash(innerHash.value, Sha256Hash::HASH_LEN, out[i]);
+	}
+	return len;
+}
+
+
+int KeyRangeEnumerator::nextAddresses(uint8_t version, char out[CHUNK_LEN][36]) {
+	assert(out != nullptr);
+	uint8_t hashes[CHUNK_LEN][Ripemd160::HASH_LEN];
+	int len = nextPubkeyHashes(hashes);
+	for (int i = 0; i < len; i++)
+		Base58Check::pubkeyHashToBase58Check(hashes[i], version, out[i]);
+	return len;
+}
@@ -0,0 +1,77 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#pragma once
+
+#include <cstdint>
+#include "CurvePoint.hpp"
+#include "PointBatch.hpp"
+#include "Ripemd160.hpp"
+#include "Uint256.hpp"
+
+
+/* 
+ * Enumerates the public keys of a range of consecutive private keys k, k + 1, ..., k + n - 1, in chunks of up to
+ * CHUNK_LEN keys. Only the starting point needs a scalar multiplication; each chunk after that is obtained by adding
+ * CHUNK_LEN * G to every point of the previous chunk, and is normalized with one shared inversion. So the cost per
+ * key is a point addition plus a few field multiplications. The range also ends before the private key would reach
+ * CurvePoint::ORDER. The last chunk can be partial. Instances are mutable and not thread-safe. Example usage:
+ *   KeyRangeEnumerator en(Uint256("...start..."), 1000000);
+ *   std::uint8_t hashes[KeyRangeEnumerator::CHUNK_LEN][Ripemd160::HASH_LEN];
+ *   while (int n = en.nextPubkeyHashes(hashes)) { ... }  // Key of hashes[i] (i < n) is the previous getNextKey() + i
+ */
+class KeyRangeEnumerator final {
+	
+	/*---- Public constants ----*/
+	
+	public: static constexpr int CHUNK_LEN = PointBatch::CAPACITY;
+	
+	
+	
+	/*---- Fields ----*/
+	
+	private: PointBatch points;  // (nextKey + i) * G for lane i
+	private: CurvePoint step;    // CHUNK_LEN * G
+	private: Uint256 nextKey;    // Private key of the next point to emit
+	private: std::uint64_t remaining;  // Number of keys not yet emitted
+	
+	
+	
+	/*---- Constructors ----*/
+	
+	// Constructs an enumerator over the given number of keys starting at the given private exponent, but stopping
+	// before CurvePoint::ORDER. Requires 0 < start < CurvePoint::ORDER. Constant-time with respect to the values.
+	public: KeyRangeEnumerator(const Uint256 &start, std::uint64_t count);
+	
+	
+	
+	/*---- Methods ----*/
+	
+	// Returns the private key of the first public key in the next chunk.
+	public: const Uint256 &getNextKey() const;
+	
+	
+	// Returns the number of keys that remain to be emitted.
+	public: std::uint64_t getRemaining() const;
+	
+	
+	// Writes the compressed public keys of the next min(CHUNK_LEN, getRemaining()) private keys to out[0], out[1], ...,
+	// and returns how many were written, which is 0 once the range is exhausted. Constant-time with respect to the keys.
+	public: int nextCompressedKeys(std::uint8_t out[CHUNK_LEN][33]);
+	
+	
+	// Writes RIPEMD-160(SHA-256(compressed public key)) of the next keys to out, and returns how many were
+	// written; with the same chunking as nextCompressedKeys(). Not constant-time.
+	public: int nextPubkeyHashes(std::uint8_t out[CHUNK_LEN][Ripemd160::HASH_LEN]);
+	
+	
+	// Writes the Base58Check pay-to-pubkey-hash addresses (with the given version byte) of the next keys to out,
+	// and returns how many were written; with the same chunking as nextCompressedKeys(). Not constant-time.
+	public: int nextAddresses(std::uint8_t version, char out[CHUNK_LEN][36]);
+	
+};
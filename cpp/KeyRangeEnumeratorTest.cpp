@@ -0,0 +1,153 @@
+/* 
+ * A runnable main program that tests the functionality of class KeyRangeEnumerator.
+ * 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include "TestHelper.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "CurvePoint.hpp"
+#include "KeyRangeEnumerator.hpp"
+#include "Ripemd160.hpp"
+#include "Sha256.hpp"
+#include "Sha256Hash.hpp"
+#include "Uint256.hpp"
+
+using std::uint8_t;
+
+static constexpr int CHUNK_LEN = KeyRangeEnumerator::CHUNK_LEN;
+
+
+// Global variables
+static int numTestCases = 0;
+
+
+/*---- Test cases ----*/
+
+static void testCompressedKeys() {
+	const char *starts[] = {
+		"0000000000000000000000000000000000000000000000000000000000000001",
+		"3A1F9C27D5E8B64C0F7A2D91E6B3C85A4F0D7E2B9C6A18F35E4D2C7B0A9F8E61",
+	};
+	for (const char *start : starts) {
+		KeyRangeEnumerator en(Uint256(start), 3 * CHUNK_LEN);
+		Uint256 key(start);
+		for (int chunk = 0; chunk < 3; chunk++) {
+			assert(en.getNextKey() == key);
+			uint8_t out[CHUNK_LEN][33];
+			assert(en.nextCompressedKeys(out) == CHUNK_LEN);
+			for (int i = 0; i < CHUNK_LEN; i++) {
+				if (chunk != 1 || i % 8 == 0) {  // Spot-check the middle chunk for speed
+					uint8_t expect[33];
+					CurvePoint::privateExponentToPublicPoint(key).toCompressedPoint(expect);
+					assert(std::memcmp(out[i], expect, sizeof(expect)) == 0);
+					numTestCases++;
+				}
+				key.add(Uint256::ONE);
+			}
+		}
+		uint8_t out[CHUNK_LEN][33];
+		assert(en.getRemaining() == 0 && en.nextCompressedKeys(out) == 0);
+	}
+}
+
+
+static void testHashesAndAddresses() {
+	const Uint256 start("00000000000000000000000000000000000000000000000000000000DEADBEEF");
+	const int count = 2 * CHUNK_LEN - 5;
+	KeyRangeEnumerator en0(start, count);
+	KeyRangeEnumerator en1(start, count);
+	KeyRangeEnumerator en2(start, count);
+	for (int chunk = 0; chunk < 2; chunk++) {
+		uint8_t keys[CHUNK_LEN][33];
+		uint8_t hashes[CHUNK_LEN][Ripemd160::HASH_LEN];
+		char addrs[CHUNK_LEN][36];
+		int len = chunk == 0 ? CHUNK_LEN : count - CHUNK_LEN;
+		assert(en0.nextCompressedKeys(keys) == len);
+		assert(en1.nextPubkeyHashes(hashes) == len);
+		assert(en2.nextAddresses(0x00, addrs) == len);
+		for (int i = 0; i < len; i++) {
+			Sha256Hash inner = Sha256::getHash(keys[i], sizeof(keys[i]));
+			uint8_t expect[Ripemd160::HASH_LEN];
+			Ripemd160::getHash(inner.value, Sha256Hash::HASH_LEN, expect);
+			assert(std::memcmp(hashes[i], expect, sizeof(expect)) == 0);
+			assert(addrs[i][0] == '1' && std::strlen(addrs[i]) >= 25);
+			numTestCases++;
+		}
+	}
+	
+	// Known addresses of private keys 1 and 2
+	KeyRangeEnumerator en(Uint256::ONE, 2);
+	char addrs[CHUNK_LEN][36];
+	assert(en.nextAddresses(0x00, addrs) == 2);
+	assert(std::strcmp(addrs[0], "1BgGZ9tcN4rm9KBzDn7KprQz87SZ26SAMH") == 0);
+	assert(std::strcmp(addrs[1], "1cMh228HTCiwS8ZsaakH8A8wze1JR5ZsP") == 0);
+	numTestCases++;
+}
+
+
+static void testEndOfRange() {
+	// Starts 100 keys before the order, so a full chunk is followed by a partial one ending at ORDER - 1
+	Uint256 start = CurvePoint::ORDER;
+	Uint256 hundred;
+	hundred.value[0] = 100;
+	start.subtract(hundred);
+	KeyRangeEnumerator en(start, UINT64_MAX);
+	assert(en.getRemaining() == 100);
+	uint8_t out[CHUNK_LEN][33];
+	assert(en.nextCompressedKeys(out) == CHUNK_LEN);
+	uint8_t expect[33];
+	Uint256 key = start;
+	Uint256 offset;
+	offset.value[0] = CHUNK_LEN;
+	key.add(offset);
+	assert(en.getNextKey() == key);
+	assert(en.nextCompressedKeys(out) == 100 - CHUNK_LEN);
+	for (int i = 0; i < 100 - CHUNK_LEN; i++) {
+		CurvePoint::privateExponentToPublicPoint(key).toCompressedPoint(expect);
+		assert(std::memcmp(out[i], expect, sizeof(expect)) == 0);
+		key.add(Uint256::ONE);
+	}
+	assert(key == CurvePoint::ORDER && en.getNextKey() == key);
+	numTestCases++;
+	
+	uint8_t hashes[CHUNK_LEN][Ripemd160::HASH_LEN];
+	assert(en.nextCompressedKeys(out) == 0);
+	assert(en.nextPubkeyHashes(hashes) == 0);
+	assert(en.nextCompressedKeys(out) == 0);
+	numTestCases++;
+	
+	// The count is the tighter bound
+	KeyRangeEnumerator en1(start, 7);
+	assert(en1.nextCompressedKeys(out) == 7);
+	assert(en1.nextCompressedKeys(out) == 0);
+	KeyRangeEnumerator en2(start, 0);
+	assert(en2.nextCompressedKeys(out) == 0);
+	numTestCases++;
+	
+	// A single key just below the order
+	start = CurvePoint::ORDER;
+	start.subtract(Uint256::ONE);
+	KeyRangeEnumerator en3(start, 1000);
+	assert(en3.getRemaining() == 1);
+	assert(en3.nextCompressedKeys(out) == 1);
+	CurvePoint::privateExponentToPublicPoint(start).toCompressedPoint(expect);
+	assert(std::memcmp(out[0], expect, sizeof(expect)) == 0);
+	assert(en3.nextCompressedKeys(out) == 0);
+	numTestCases++;
+}
+
+
+int main() {
+	testCompressedKeys();
+	testHashesAndAddresses();
+	testEndOfRange();
+	std::printf("All %d test cases passed\n", numTestCases);
+	return EXIT_SUCCESS;
+}
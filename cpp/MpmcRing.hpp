@@ -0,0 +1,161 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#pragma once
+
+#include <atomic>
+#include <cassert>
+#include <cstddef>
+#include <cstdint>
+#include <memory>
+#include <utility>
+
+
+/* 
+ * A bounded, lock-free, multi-producer multi-consumer FIFO queue with a power-of-2 capacity (the algorithm of
+ * Dmitry Vyukov). Each slot carries a sequence number that says whether it is ready to be written or read for
+ * the current lap, so producers and consumers only contend on one compare-and-swap of their own position
+ * counter, and never allocate. All methods may be called concurrently. The element type must be default-
+ * constructible and move-assignable. Example usage:
+ *   MpmcRing<Job> ring(1024);
+ *   if (!ring.tryPush(job)) { ... full ... }
+ *   Job out;
+ *   if (ring.tryPop(out)) { ... }
+ */
+template <typename T>
+class MpmcRing final {
+	
+	/*---- Types ----*/
+	
+	private: struct Slot {
+		std::atomic<std::size_t> sequence;
+		T value;
+	};
+	
+	
+	
+	/*---- Fields ----*/
+	
+	private: std::unique_ptr<Slot[]> slots;
+	private: std::size_t mask;  // Capacity minus 1
+	private: char padding0[64];  // Keep the two counters on separate cache lines
+	private: std::atomic<std::size_t> pushPosition;
+	private: char padding1[64];
+	private: std::atomic<std::size_t> popPosition;
+	private: char padding2[64];
+	
+	
+	
+	/*---- Constructors ----*/
+	
+	// Constructs an empty ring with the given capacity, which must be a power of 2 and at least 2.
+	public: explicit MpmcRing(std::size_t capacity);
+	
+	
+	public: MpmcRing(const MpmcRing &other) = delete;
+	
+	public: MpmcRing &operator=(const MpmcRing &other) = delete;
+	
+	
+	
+	/*---- Methods ----*/
+	
+	// Moves the given value into the back of the ring and returns true, or returns false
+	// (leaving the value unchanged) if the ring is full.
+	public: bool tryPush(T &val);
+	
+	
+	// Moves the front value of the ring into out and returns true, or returns false if the ring is empty.
+	// A value whose push is still in progress counts as absent.
+	public: bool tryPop(T &out);
+	
+	
+	// Returns the number of values in the ring. Only a snapshot when other threads are active.
+	public: std::size_t getSize() const;
+	
+	
+	public: std::size_t getCapacity() const;
+	
+};
+
+
+
+/*---- Template implementation ----*/
+
+template <typename T>
+MpmcRing<T>::MpmcRing(std::size_t capacity) :
+		slots(new Slot[capacity]),
+		mask(capacity - 1),
+		pushPosition(0),
+		popPosition(0) {
+	assert(capacity >= 2 && (capacity & (capacity - 1)) == 0);
+	for (std::size_t i = 0; i < capacity; i++)
+		slots[i].sequence.store(i, std::memory_order_relaxed);
+}
+
+
+template <typename T>
+bool MpmcRing<T>::tryPush(T &val) {
+	/* 
+	 * A slot whose sequence equals the position is free for that lap; one that is behind
+	 * still holds the value from the previous lap, so the ring is full.
+	 */
+	std::size_t pos = pushPosition.load(std::memory_order_relaxed);
+	Slot *slot;
+	while (true) {
+		slot = &slots[pos & mask];
+		std::size_t seq = slot->sequence.load(std::memory_order_acquire);
+		std::intptr_t diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos);
+		if (diff == 0) {
+			if (pushPosition.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		} else if (diff < 0)
+			return false;
+		else
+			pos = pushPosition.load(std::memory_order_relaxed);
+	}
+	slot->value = std::move(val);
+	slot->sequence.store(pos + 1, std::memory_order_release);
+	return true;
+}
+
+
+template <typename T>
+bool MpmcRing<T>::tryPop(T &out) {
+	std::size_t pos = popPosition.load(std::memory_order_relaxed);
+	Slot *slot;
+	while (true) {
+		slot = &slots[pos & mask];
+		std::size_t seq = slot->sequence.load(std::memory_order_acquire);
+		std::intptr_t diff = static_cast<std::intptr_t>(seq) - static_cast<std::intptr_t>(pos + 1);
+		if (diff == 0) {
+			if (popPosition.compare_exchange_weak(pos, pos + 1, std::memory_order_relaxed))
+				break;
+		} else if (diff < 0)
+			return false;
+		else
+			pos = popPosition.load(std::memory_order_relaxed);
+	}
+	out = std::move(slot->value);
+	slot->sequence.store(pos + mask + 1, std::memory_order_release);  // Free for the next lap
+	return true;
+}
+
+
+template <typename T>
+std::size_t MpmcRing<T>::getSize() const {
+	std::size_t pop = popPosition.load();
+	std::size_t push = pushPosition.load();
+	return push >= pop ? push - pop : 0;
+}
+
+
+template <typename T>
+std::size_t MpmcRing<T>::getCapacity() const {
+	return mask + 1;
+}
@@ -0,0 +1,99 @@
+/* 
+ * A runnable main program that tests the functionality of class MpmcRing.
+ * 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include "TestHelper.hpp"
+#include <atomic>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include "MpmcRing.hpp"
+
+
+// Global variables
+static int numTestCases = 0;
+
+
+/*---- Test cases ----*/
+
+static void testSingleThread() {
+	MpmcRing<int> ring(4);
+	assert(ring.getCapacity() == 4 && ring.getSize() == 0);
+	int out = -1;
+	assert(!ring.tryPop(out) && out == -1);
+	for (int lap = 0; lap < 3; lap++) {  // Wrap around several times
+		for (int i = 0; i < 4; i++) {
+			int val = lap * 10 + i;
+			assert(ring.tryPush(val));
+		}
+		int extra = 99;
+		assert(!ring.tryPush(extra) && extra == 99);
+		assert(ring.getSize() == 4);
+		for (int i = 0; i < 4; i++) {
+			assert(ring.tryPop(out) && out == lap * 10 + i);
+		}
+		assert(!ring.tryPop(out));
+		numTestCases++;
+	}
+	
+	// Move-only values are moved in and out
+	MpmcRing<std::unique_ptr<int> > ptrs(2);
+	std::unique_ptr<int> p(new int(7));
+	assert(ptrs.tryPush(p) && p == nullptr);
+	std::unique_ptr<int> q;
+	assert(ptrs.tryPop(q) && *q == 7);
+	numTestCases++;
+}
+
+
+static void testConcurrent() {
+	const int numProducers = 3;
+	const int numConsumers = 3;
+	const long perProducer = 20000;
+	MpmcRing<long> ring(64);
+	std::atomic<long> sum(0);
+	std::atomic<long> count(0);
+	vector<std::thread> threads;
+	for (int t = 0; t < numProducers; t++) {
+		threads.emplace_back([&ring, t, perProducer]() {
+			for (long i = 1; i <= perProducer; i++) {
+				long val = t * perProducer + i;
+				while (!ring.tryPush(val))
+					std::this_thread::yield();
+			}
+		});
+	}
+	for (int t = 0; t < numConsumers; t++) {
+		threads.emplace_back([&ring, &sum, &count, numProducers, perProducer]() {
+			long val;
+			while (count.load() < numProducers * perProducer) {
+				if (ring.tryPop(val)) {
+					sum += val;
+					count++;
+				} else
+					std::this_thread::yield();
+			}
+		});
+	}
+	for (std::thread &th : threads)
+		th.join();
+	long n = numProducers * perProducer;
+	assert(count.load() == n && sum.load() == n * (n + 1) / 2);  // Every value exactly once
+	assert(ring.getSize() == 0);
+	numTestCases++;
+}
+
+
+int main() {
+	testSingleThread();
+	testConcurrent();
+	std::printf("All %d test cases passed\n", numTestCases);
+	return EXIT_SUCCESS;
+}
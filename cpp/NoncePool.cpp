@@ -0,0 +1,147 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include <cassert>
+#include <random>
+#include <type_traits>
+#include "Ecdsa.hpp"
+#include "NoncePool.hpp"
+#include "Utils.hpp"
+
+using std::size_t;
+using std::uint8_t;
+using std::uint32_t;
+using std::uint64_t;
+
+
+// Returns a seed of 32 bytes from the system's random source.
+static Sha256Hash getRandomSeed() {
+	uint8_t bytes[Sha256Hash::HASH_LEN];
+	std::random_device rand;
+	for (int i = 0; i < Sha256Hash::HASH_LEN; i += 4) {
+		uint32_t word = rand();
+		for (int j = 0; j < 4; j++)
+			bytes[i + j] = static_cast<uint8_t>(word >> (j * 8));
+	}
+	const Sha256Hash result(bytes, sizeof(bytes));
+	Utils::secureZero(bytes, sizeof(bytes));
+	return result;
+}
+
+
+NoncePool::Nonce::Nonce() :
+	point(CurvePoint::ZERO),
+	inverse() {}
+
+
+NoncePool::NoncePool(const Uint256 &privKey, size_t depth) :
+		privateKey(privKey),
+		generator(privKey, getRandomSeed()),
+		nonces(depth),
+		head(0),
+		count(0),
+		stopping(false),
+		misses(0) {
+	assert(depth >= 1);
+	thread = std::thread(&NoncePool::fillLoop, this);
+}
+
+
+NoncePool::~NoncePool() {
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		stopping = true;
+	}
+	spaceAvailable.notify_all();
+	thread.join();
+	for (Nonce &nonce : nonces)
+		zeroize(nonce);
+	static_assert(std::is_trivially_copyable<Uint256>::value, "Must be overwritable as bytes");
+	Utils::secureZero(&privateKey, sizeof(privateKey));
+}
+
+
+void NoncePool::sign(const Sha256Hash &msgHash, Uint256 &outR, Uint256 &outS) {
+	Nonce nonce;
+	bool ok;
+	do {
+		bool taken = false;
+		{
+			std::lock_guard<std::mutex> lock(mutex);
+			if (count > 0) {
+				nonce = nonces[head];
+				zeroize(nonces[head]);  // Never handed out again
+				head = (head + 1) % nonces.size();
+				count--;
+				taken = true;
+			}
+		}
+		if (taken)
+			spaceAvailable.notify_one();
+		else {
+			misses++;
+			prepareNonce(nonce);
+		}
+		ok = Ecdsa::signWithPrecomputedNonce(privateKey, msgHash, nonce.point, nonce.inverse, outR, outS);
+		zeroize(nonce);
+	} while (!ok);
+}
+
+
+size_t NoncePool::getDepth() const {
+	return nonces.size();
+}
+
+
+size_t NoncePool::getAvailable() {
+	std::lock_guard<std::mutex> lock(mutex);
+	return count;
+}
+
+
+uint64_t NoncePool::getMisses() const {
+	return misses.load();
+}
+
+
+void NoncePool::fillLoop() {
+	Nonce nonce;
+	while (true) {
+		{
+			std::unique_lock<std::mutex> lock(mutex);
+			spaceAvailable.wait(lock, [this]() { return stopping || count < nonces.size(); });
+			if (stopping)
+				break;
+		}
+		// Only this thread adds nonces, so there is still room after the expensive work
+		prepareNonce(nonce);
+		std::lock_guard<std::mutex> lock(mutex);
+		nonces[(head + count) % nonces.size()] = nonce;
+		count++;
+		zeroize(nonce);
+	}
+}
+
+
+void NoncePool::prepareNonce(Nonce &out) {
+	Uint256 k;
+	{
+		std::lock_guard<std::mutex> lock(generatorMutex);
+		k = generator.next();  // In the range [1, CurvePoint::ORDER)
+	}
+	out.point = CurvePoint::privateExponentToPublicPoint(k);
+	k.reciprocal(CurvePoint::ORDER);
+	out.inverse = k;
+	Utils::secureZero(&k, sizeof(k));
+}
+
+
+void NoncePool::zeroize(Nonce &nonce) {
+	static_assert(std::is_trivially_copyable<Nonce>::value, "Must be overwritable as bytes");
+	Utils::secureZero(&nonce, sizeof(nonce));
+}
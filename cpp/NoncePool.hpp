@@ -0,0 +1,121 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "CurvePoint.hpp"
+#include "Rfc6979.hpp"
+#include "Sha256Hash.hpp"
+#include "Uint256.hpp"
+
+
+/* 
+ * Signs messages with one private key at low latency by preparing nonces ahead of time. Nearly all the cost of
+ * Ecdsa::sign() (the point k * G, its normalization, and k^-1) does not depend on the message, so a background
+ * thread keeps up to a configured depth of (k * G, k^-1) pairs ready, and signing takes one and finishes with
+ * Ecdsa::signWithPrecomputedNonce(). If the pool runs dry, the signing thread prepares a nonce itself.
+ * 
+ * The nonces come from an RFC 6979 generator (see class Rfc6979) keyed with the private key and seeded with
+ * 32 bytes from std::random_device, so they stay secret even if either input is weak, and the signatures are
+ * not deterministic. Each nonce is handed out once, and its slot and the pool's other copies are zeroized; the
+ * private key and the generator's HMAC state are zeroized by the destructor. Temporaries inside the hashing and
+ * curve arithmetic are not erased. All methods may be called concurrently. The object holds secret key material.
+ * Example usage:
+ *   NoncePool pool(privKey, 64);
+ *   Uint256 r, s;
+ *   pool.sign(msgHash, r, s);
+ */
+class NoncePool final {
+	
+	/*---- Types ----*/
+	
+	private: struct Nonce {
+		CurvePoint point;  // k * G, normalized
+		Uint256 inverse;   // k^-1 % CurvePoint::ORDER
+		
+		Nonce();
+	};
+	
+	
+	
+	/*---- Fields ----*/
+	
+	private: Uint256 privateKey;
+	
+	private: std::mutex generatorMutex;  // Guards generator
+	private: Rfc6979 generator;
+	
+	private: std::mutex mutex;  // Guards the ring of nonces and stopping
+	private: std::condition_variable spaceAvailable;
+	private: std::vector<Nonce> nonces;  // Ring buffer whose length is the depth
+	private: std::size_t head;  // Index of the oldest nonce
+	private: std::size_t count;
+	private: bool stopping;
+	
+	private: std::atomic<std::uint64_t> misses;
+	private: std::thread thread;
+	
+	
+	
+	/*---- Constructors ----*/
+	
+	// Constructs a pool for the given private key, which must be in the range [1, CurvePoint::ORDER), and
+	// starts a background thread that keeps up to depth nonces ready, where depth must be at least 1.
+	public: explicit NoncePool(const Uint256 &privKey, std::size_t depth);
+	
+	
+	// Stops the background thread and zeroizes the unused nonces, the private key, and the generator state.
+	public: ~NoncePool();
+	
+	
+	NoncePool(const NoncePool &) = delete;
+	NoncePool &operator=(const NoncePool &) = delete;
+	
+	
+	
+	/*---- Methods ----*/
+	
+	// Signs the given message hash with this pool's private key and a fresh nonce, producing r and s in the
+	// range [1, CurvePoint::ORDER) with a low s value. If a nonce fails (vanishing probability), another one is used,
+	// so this always succeeds. Does not block on the background thread. The arithmetic is constant-time with
+	// respect to the private key and nonce, as in Ecdsa::sign().
+	public: void sign(const Sha256Hash &msgHash, Uint256 &outR, Uint256 &outS);
+	
+	
+	// Returns the most nonces kept ready.
+	public: std::size_t getDepth() const;
+	
+	
+	// Returns the number of nonces ready now. Only a snapshot, for monitoring.
+	public: std::size_t getAvailable();
+	
+	
+	// Returns the number of nonces that sign() had to prepare itself because the pool was empty,
+	// which suggests a larger depth if it grows steadily.
+	public: std::uint64_t getMisses() const;
+	
+	
+	// The main loop of the background thread.
+	private: void fillLoop();
+	
+	
+	// Sets out to a new nonce from the generator. Constant-time with respect to the nonce.
+	private: void prepareNonce(Nonce &out);
+	
+	
+	// Overwrites the given nonce in a way that the compiler cannot optimize away.
+	private: static void zeroize(Nonce &nonce);
+	
+};
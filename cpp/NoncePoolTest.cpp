@@ -0,0 +1,148 @@
+/* 
+ * A runnable main program that tests the functionality of class NoncePool.
+ * 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include "TestHelper.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <set>
+#include <thread>
+#include "CurvePoint.hpp"
+#include "DerSignature.hpp"
+#include "Ecdsa.hpp"
+#include "NoncePool.hpp"
+#include "Sha256.hpp"
+#include "Sha256Hash.hpp"
+#include "Uint256.hpp"
+
+using std::uint8_t;
+
+
+// Global variables
+static int numTestCases = 0;
+
+
+/*---- Test cases ----*/
+
+static void testSignAndVerify() {
+	const Uint256 privKey("C85AFBACCF3E1EE40BDCD721A9AD1341344775D51840EFC0511E0182AE92F78E");
+	const CurvePoint pubKey = CurvePoint::privateExponentToPublicPoint(privKey);
+	NoncePool pool(privKey, 8);
+	assert(pool.getDepth() == 8);
+	std::set<Bytes> seenRs;
+	for (int i = 0; i < 40; i++) {
+		const uint8_t msg[] = {static_cast<uint8_t>(i)};
+		const Sha256Hash msgHash = Sha256::getHash(msg, sizeof(msg));
+		Uint256 r, s;
+		pool.sign(msgHash, r, s);
+		assert(Ecdsa::verify(pubKey, msgHash, r, s));
+		assert(DerSignature::isLowS(s));
+		assert(pool.getAvailable() <= 8);
+		
+		// Every nonce is fresh, so no r value repeats
+		Bytes rBytes(32);
+		r.getBigEndianBytes(rBytes.data());
+		assert(seenRs.insert(rBytes).second);
+		numTestCases++;
+	}
+	
+	// Signing the same message twice uses different nonces
+	const Sha256Hash msgHash = Sha256::getHash(nullptr, 0);
+	Uint256 r0, s0, r1, s1;
+	pool.sign(msgHash, r0, s0);
+	pool.sign(msgHash, r1, s1);
+	assert(r0 != r1 && Ecdsa::verify(pubKey, msgHash, r0, s0) && Ecdsa::verify(pubKey, msgHash, r1, s1));
+	numTestCases++;
+}
+
+
+static void testPrecomputedNonce() {
+	// Same result as Ecdsa::sign() with the nonce
+	const Uint256 privKey = Uint256::ONE;
+	const Uint256 nonce("0000000000000000000000000000000000000000000000000000000000000003");
+	const Sha256Hash msgHash = Sha256::getHash(nullptr, 0);
+	Uint256 nonceInverse = nonce;
+	nonceInverse.reciprocal(CurvePoint::ORDER);
+	Uint256 r0, s0, r1, s1;
+	assert(Ecdsa::sign(privKey, msgHash, nonce, r0, s0));
+	assert(Ecdsa::signWithPrecomputedNonce(privKey, msgHash, CurvePoint::privateExponentToPublicPoint(nonce),
+		nonceInverse, r1, s1));
+	assert(r0 == r1 && s0 == s1);
+	numTestCases++;
+}
+
+
+static void testConcurrentSigning() {
+	// A depth of 1 makes the signing threads often find the pool empty and prepare nonces themselves
+	const Uint256 privKey("0000000000000000000000000000000000000000000000000000000000000007");
+	const CurvePoint pubKey = CurvePoint::privateExponentToPublicPoint(privKey);
+	NoncePool pool(privKey, 1);
+	constexpr int numThreads = 4;
+	constexpr int numSigs = 10;
+	vector<std::thread> threads;
+	vector<Uint256> rs(numThreads * numSigs), ss(numThreads * numSigs);
+	for (int t = 0; t < numThreads; t++) {
+		threads.push_back(std::thread([&, t]() {
+			for (int i = 0; i < numSigs; i++) {
+				const uint8_t msg[] = {static_cast<uint8_t>(t), static_cast<uint8_t>(i)};
+				pool.sign(Sha256::getHash(msg, sizeof(msg)), rs[t * numSigs + i], ss[t * numSigs + i]);
+			}
+		}));
+	}
+	for (std::thread &th : threads)
+		th.join();
+	
+	std::set<Bytes> seenRs;
+	for (int t = 0; t < numThreads; t++) {
+		for (int i = 0; i < numSigs; i++) {
+			const uint8_t msg[] = {static_cast<uint8_t>(t), static_cast<uint8_t>(i)};
+			const Uint256 &r = rs[t * numSigs + i];
+			assert(Ecdsa::verify(pubKey, Sha256::getHash(msg, sizeof(msg)), r, ss[t * numSigs + i]));
+			Bytes rBytes(32);
+			r.getBigEndianBytes(rBytes.data());
+			assert(seenRs.insert(rBytes).second);
+			numTestCases++;
+		}
+	}
+	assert(pool.getAvailable() <= pool.getDepth());
+	numTestCases++;
+}
+
+
+static void testMissWhenDrained() {
+	// Signing with a pooled nonce is far cheaper than preparing one, so back-to-back signing drains a pool of
+	// depth 1 and forces sign() to prepare its own nonce; such signatures must be just as valid and fresh
+	const Uint256 privKey("0000000000000000000000000000000000000000000000000000000000000009");
+	const CurvePoint pubKey = CurvePoint::privateExponentToPublicPoint(privKey);
+	NoncePool pool(privKey, 1);
+	std::set<Bytes> seenRs;
+	for (int i = 0; i < 1000 && pool.getMisses() == 0; i++) {
+		const uint8_t msg[] = {static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8)};
+		const Sha256Hash msgHash = Sha256::getHash(msg, sizeof(msg));
+		Uint256 r, s;
+		pool.sign(msgHash, r, s);
+		assert(Ecdsa::verify(pubKey, msgHash, r, s));
+		Bytes rBytes(32);
+		r.getBigEndianBytes(rBytes.data());
+		assert(seenRs.insert(rBytes).second);
+		assert(pool.getAvailable() <= pool.getDepth());
+	}
+	assert(pool.getMisses() > 0);
+	numTestCases++;
+}
+
+
+int main() {
+	testSignAndVerify();
+	testPrecomputedNonce();
+	testConcurrentSigning();
+	testMissWhenDrained();
+	std::printf("All %d test cases passed\n", numTestCases);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,462 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include <algorithm>
+#include <cassert>
+#include <cstring>
+#include <thread>
+#include <vector>
+#include "CountOps.hpp"
+#include "PointBatch.hpp"
+
+using std::size_t;
+using std::uint8_t;
+using std::uint32_t;
+using std::uint64_t;
+
+
+PointBatch::PointBatch(int n) :
+		size(n) {
+	assert(0 <= n && n <= CAPACITY);
+	for (int i = 0; i < CAPACITY; i++)
+		set(i, CurvePoint::ZERO);
+}
+
+
+PointBatch::PointBatch(const CurvePoint points[], int n) :
+		PointBatch(n) {
+	assert(points != nullptr || n == 0);
+	for (int i = 0; i < n; i++)
+		set(i, points[i]);
+}
+
+
+int PointBatch::getSize() const {
+	return size;
+}
+
+
+CurvePoint PointBatch::get(int index) const {
+	assert(0 <= index && index < size);
+	const Block &b = blocks[index / LANE_GROUP];
+	int lane = index % LANE_GROUP;
+	CurvePoint result = CurvePoint::ZERO;
+	result.x = getLane(b.x, lane);
+	result.y = getLane(b.y, lane);
+	result.z = getLane(b.z, lane);
+	return result;
+}
+
+
+void PointBatch::set(int index, const CurvePoint &pt) {
+	assert(0 <= index && index < CAPACITY);
+	Block &b = blocks[index / LANE_GROUP];
+	int lane = index % LANE_GROUP;
+	setLane(b.x, lane, pt.x);
+	setLane(b.y, lane, pt.y);
+	setLane(b.z, lane, pt.z);
+}
+
+
+void PointBatch::add(const PointBatch &other) {
+	assert(other.size == size);
+	countOps(functionOps);
+	for (int i = 0; i < (size + LANE_GROUP - 1) / LANE_GROUP; i++) {
+		countOps(loopBodyOps);
+		addBlock(blocks[i], other.blocks[i]);
+	}
+}
+
+
+void PointBatch::add(const CurvePoint &pt) {
+	countOps(functionOps);
+	Block broadcast;
+	for (int i = 0; i < LANE_GROUP; i++) {
+		setLane(broadcast.x, i, pt.x);
+		setLane(broadcast.y, i, pt.y);
+		setLane(broadcast.z, i, pt.z);
+	}
+	for (int i = 0; i < (size + LANE_GROUP - 1) / LANE_GROUP; i++) {
+		countOps(loopBodyOps);
+		addBlock(blocks[i], broadcast);
+	}
+}
+
+
+void PointBatch::twice() {
+	countOps(functionOps);
+	for (int i = 0; i < (size + LANE_GROUP - 1) / LANE_GROUP; i++) {
+		countOps(loopBodyOps);
+		twiceBlock(blocks[i]);
+	}
+}
+
+
+void PointBatch::normalize() {
+	/* 
+	 * Algorithm pseudocode (Montgomery's trick, with zero z values replaced by 1 so they do not spoil the product):
+	 * acc = 1
+	 * for i in [0, size):
+	 *   prefix[i] = acc
+	 *   acc *= z[i]
+	 * acc = 1 / acc
+	 * for i in (size, 0]:
+	 *   inv = prefix[i] * acc  // 1 / z[i]
+	 *   acc *= z[i]
+	 *   (x[i], y[i], z[i]) = (x[i] * inv, y[i] * inv, 1), or the CurvePoint::normalize() result for zero
+	 */
+	countOps(functionOps);
+	const FieldInt &one = CurvePoint::FI_ONE;
+	const FieldInt &zero = CurvePoint::FI_ZERO;
+	uint32_t prefix[CAPACITY][Uint256::NUM_WORDS];
+	FieldInt acc = one;
+	for (int i = 0; i < size; i++) {
+		countOps(loopBodyOps);
+		const Block &b = blocks[i / LANE_GROUP];
+		FieldInt z = getLane(b.z, i % LANE_GROUP);
+		z.replace(one, static_cast<uint32_t>(z == zero));
+		std::memcpy(prefix[i], acc.value, sizeof(prefix[i]));
+		acc.multiply(z);
+	}
+	acc.reciprocal();
+	
+	for (int i = size - 1; i >= 0; i--) {
+		countOps(loopBodyOps);
+		Block &b = blocks[i / LANE_GROUP];
+		int lane = i % LANE_GROUP;
+		FieldInt x = getLane(b.x, lane);
+		FieldInt y = getLane(b.y, lane);
+		FieldInt z = getLane(b.z, lane);
+		uint32_t isZero = static_cast<uint32_t>(z == zero);
+		z.replace(one, isZero);
+		
+		FieldInt inv = one;
+		std::memcpy(inv.value, prefix[i], sizeof(prefix[i]));
+		inv.multiply(acc);
+		acc.multiply(z);
+		
+		FieldInt normX = x;
+		normX.multiply(inv);
+		FieldInt normY = y;
+		normY.multiply(inv);
+		x.replace(one, static_cast<uint32_t>(x != zero));
+		y.replace(one, static_cast<uint32_t>(y != zero));
+		normX.replace(x, isZero);
+		normY.replace(y, isZero);
+		z = one;
+		z.replace(zero, isZero);
+		setLane(b.x, lane, normX);
+		setLane(b.y, lane, normY);
+		setLane(b.z, lane, z);
+		countOps(6 * fieldintCopyOps);
+	}
+}
+
+
+void PointBatch::toCompressedPoints(uint8_t output[][33]) const {
+	assert(output != nullptr || size == 0);
+	for (int i = 0; i < size; i++)
+		get(i).toCompressedPoint(output[i]);
+}
+
+
+void PointBatch::toUncompressedPoints(uint8_t output[][65]) const {
+	assert(output != nullptr || size == 0);
+	for (int i = 0; i < size; i++)
+		get(i).toUncompressedPoint(output[i]);
+}
+
+
+void PointBatch::privateExponentsToCompressedKeys(const Uint256 privExps[], size_t n, uint8_t outKeys[][33], int numThreads) {
+	assert((privExps != nullptr && outKeys != nullptr) || n == 0);
+	assert(numThreads >= 1);
+	size_t numChunks = (n + CAPACITY - 1) / CAPACITY;
+	size_t step = std::min(static_cast<size_t>(numThreads), numChunks);
+	if (step <= 1) {
+		compressedKeysWorker(privExps, n, outKeys, 0, 1);
+		return;
+	}
+	std::vector<std::thread> threads;
+	for (size_t i = 1; i < step; i++)
+		threads.emplace_back(compressedKeysWorker, privExps, n, outKeys, i, step);
+	compressedKeysWorker(privExps, n, outKeys, 0, step);
+	for (std::thread &th : threads)
+		th.join();
+}
+
+
+void PointBatch::compressedKeysWorker(const Uint256 privExps[], size_t n, uint8_t outKeys[][33], size_t first, size_t step) {
+	for (size_t start = first * CAPACITY; start < n; start += step * CAPACITY) {
+		int len = static_cast<int>(std::min(n - start, static_cast<size_t>(CAPACITY)));
+		PointBatch batch(len);
+		for (int i = 0; i < len; i++) {
+			const Uint256 &privExp = privExps[start + i];
+			assert((Uint256::ZERO < privExp) & (privExp < CurvePoint::ORDER));
+			batch.set(i, CurvePoint::multiplyGenerator(privExp));
+		}
+		batch.normalize();
+		batch.toCompressedPoints(&outKeys[start]);
+	}
+}
+
+
+void PointBatch::addBlock(Block &p, const Block &q) {
+	countOps(functionOps);
+	/* 
+	 * Complete addition for a = 0 (Renes, Costello, Batina, "Complete addition formulas for
+	 * prime order elliptic curves", algorithm 7), with b3 = 3 * b. Algorithm pseudocode:
+	 * t0 = x0 * x1;  t1 = y0 * y1;  t2 = z0 * z1
+	 * t3 = (x0 + y0) * (x1 + y1) - (t0 + t1)
+	 * t4 = (y0 + z0) * (y1 + z1) - (t1 + t2)
+	 * y' = (x0 + z0) * (x1 + z1) - (t0 + t2)
+	 * t0 = 3 * t0;  t2 = b3 * t2
+	 * z' = t1 + t2;  t1 = t1 - t2;  y' = b3 * y'
+	 * x' = t3 * t1 - t4 * y'
+	 * y' = t1 * z' + y' * t0
+	 * z' = z' * t4 + t0 * t3
+	 */
+	FieldGroup t0, t1, t2, t3, t4, x3, y3, z3;
+	fieldMultiply(t0, p.x, q.x);
+	fieldMultiply(t1, p.y, q.y);
+	fieldMultiply(t2, p.z, q.z);
+	fieldAdd(t3, p.x, p.y);
+	fieldAdd(t4, q.x, q.y);
+	fieldMultiply(t3, t3, t4);
+	fieldAdd(t4, t0, t1);
+	fieldSubtract(t3, t3, t4);
+	fieldAdd(t4, p.y, p.z);
+	fieldAdd(x3, q.y, q.z);
+	fieldMultiply(t4, t4, x3);
+	fieldAdd(x3, t1, t2);
+	fieldSubtract(t4, t4, x3);
+	fieldAdd(x3, p.x, p.z);
+	fieldAdd(y3, q.x, q.z);
+	fieldMultiply(x3, x3, y3);
+	fieldAdd(y3, t0, t2);
+	fieldSubtract(y3, x3, y3);
+	fieldAdd(x3, t0, t0);
+	fieldAdd(t0, x3, t0);
+	fieldMultiplyB3(t2);
+	fieldAdd(z3, t1, t2);
+	fieldSubtract(t1, t1, t2);
+	fieldMultiplyB3(y3);
+	fieldMultiply(x3, t4, y3);
+	fieldMultiply(t2, t3, t1);
+	fieldSubtract(x3, t2, x3);
+	fieldMultiply(y3, y3, t0);
+	fieldMultiply(t1, t1, z3);
+	fieldAdd(y3, t1, y3);
+	fieldMultiply(t0, t0, t3);
+	fieldMultiply(z3, z3, t4);
+	fieldAdd(z3, z3, t0);
+	std::memcpy(p.x, x3, sizeof(x3));
+	std::memcpy(p.y, y3, sizeof(y3));
+	std::memcpy(p.z, z3, sizeof(z3));
+	countOps(3 * Uint256::NUM_WORDS * LANE_GROUP * arithmeticOps);
+}
+
+
+void PointBatch::twiceBlock(Block &p) {
+	countOps(functionOps);
+	/* 
+	 * Complete doubling for a = 0 (ibid., algorithm 9). Algorithm pseudocode:
+	 * t0 = y^2;  t1 = y * z;  t2 = b3 * z^2
+	 * x' = 2 * (t0 - 3 * t2) * x * y
+	 * y' = (t0 - 3 * t2) * (t0 + t2) + 8 * t0 * t2
+	 * z' = 8 * t0 * t1
+	 */
+	FieldGroup t0, t1, t2, x3, y3, z3;
+	fieldMultiply(t0, p.y, p.y);
+	fieldAdd(z3, t0, t0);
+	fieldAdd(z3, z3, z3);
+	fieldAdd(z3, z3, z3);
+	fieldMultiply(t1, p.y, p.z);
+	fieldMultiply(t2, p.z, p.z);
+	fieldMultiplyB3(t2);
+	fieldMultiply(x3, t2, z3);
+	fieldAdd(y3, t0, t2);
+	fieldMultiply(z3, t1, z3);
+	fieldAdd(t1, t2, t2);
+	fieldAdd(t2, t1, t2);
+	fieldSubtract(t0, t0, t2);
+	fieldMultiply(y3, t0, y3);
+	fieldAdd(y3, x3, y3);
+	fieldMultiply(t1, p.x, p.y);
+	fieldMultiply(x3, t0, t1);
+	fieldAdd(x3, x3, x3);
+	std::memcpy(p.x, x3, sizeof(x3));
+	std::memcpy(p.y, y3, sizeof(y3));
+	std::memcpy(p.z, z3, sizeof(z3));
+	countOps(3 * Uint256::NUM_WORDS * LANE_GROUP * arithmeticOps);
+}
+
+
+void PointBatch::fieldAdd(FieldGroup &out, const FieldGroup &a, const FieldGroup &b) {
+	countOps(functionOps);
+	uint32_t carry[LANE_GROUP] = {};
+	for (int i = 0; i < Uint256::NUM_WORDS; i++) {
+		for (int j = 0; j < LANE_GROUP; j++) {
+			uint64_t sum = static_cast<uint64_t>(a[i][j]) + b[i][j] + carry[j];
+			out[i][j] = static_cast<uint32_t>(sum);
+			carry[j] = static_cast<uint32_t>(sum >> 32);
+		}
+		countOps(LANE_GROUP * 8 * arithmeticOps);
+	}
+	reduceOnce(out, carry);
+}
+
+
+void PointBatch::fieldSubtract(FieldGroup &out, const FieldGroup &a, const FieldGroup &b) {
+	countOps(functionOps);
+	uint32_t borrow[LANE_GROUP] = {};
+	for (int i = 0; i < Uint256::NUM_WORDS; i++) {
+		for (int j = 0; j < LANE_GROUP; j++) {
+			uint64_t diff = static_cast<uint64_t>(a[i][j]) - b[i][j] - borrow[j];
+			out[i][j] = static_cast<uint32_t>(diff);
+			borrow[j] = -static_cast<uint32_t>(diff >> 32);
+		}
+		countOps(LANE_GROUP * 9 * arithmeticOps);
+	}
+	// Add the modulus back to each lane that went negative
+	uint32_t carry[LANE_GROUP] = {};
+	for (int i = 0; i < Uint256::NUM_WORDS; i++) {
+		for (int j = 0; j < LANE_GROUP; j++) {
+			uint64_t sum = static_cast<uint64_t>(out[i][j]) + (MODULUS[i] & -borrow[j]) + carry[j];
+			out[i][j] = static_cast<uint32_t>(sum);
+			carry[j] = static_cast<uint32_t>(sum >> 32);
+		}
+		countOps(LANE_GROUP * 10 * arithmeticOps);
+	}
+}
+
+
+void PointBatch::fieldMultiply(FieldGroup &out, const FieldGroup &a, const FieldGroup &b) {
+	countOps(functionOps);
+	// Column-wise long multiplication. The low and high halves of each 32x32-bit partial product are summed
+	// separately, so that a column's sum cannot overflow 64 bits and there is no carry chain inside a column.
+	uint32_t product[Uint256::NUM_WORDS * 2][LANE_GROUP];
+	uint64_t carry[LANE_GROUP] = {};  // Includes the high halves from the previous column
+	for (int k = 0; k < Uint256::NUM_WORDS * 2; k++) {
+		uint64_t low[LANE_GROUP] = {};
+		uint64_t high[LANE_GROUP] = {};
+		for (int i = (k < Uint256::NUM_WORDS ? 0 : k - Uint256::NUM_WORDS + 1); i <= k && i < Uint256::NUM_WORDS; i++) {
+			for (int j = 0; j < LANE_GROUP; j++) {
+				uint64_t prod = static_cast<uint64_t>(a[i][j]) * b[k - i][j];
+				low[j] += static_cast<uint32_t>(prod);
+				high[j] += prod >> 32;
+			}
+			countOps(LANE_GROUP * 7 * arithmeticOps);
+		}
+		for (int j = 0; j < LANE_GROUP; j++) {
+			uint64_t sum = low[j] + carry[j];
+			product[k][j] = static_cast<uint32_t>(sum);
+			carry[j] = (sum >> 32) + high[j];
+		}
+		countOps(LANE_GROUP * 6 * arithmeticOps);
+	}
+	
+	// Fold the high half down using 2^256 = 2^32 + 0x3D1 (mod p). The
+	// result fits in 256 bits plus a top word that is less than 2^33.
+	uint64_t top[LANE_GROUP];
+	for (int j = 0; j < LANE_GROUP; j++)
+		carry[j] = 0;
+	for (int i = 0; i < Uint256::NUM_WORDS; i++) {
+		for (int j = 0; j < LANE_GROUP; j++) {
+			uint64_t sum = carry[j] + product[i][j] + static_cast<uint64_t>(product[i + Uint256::NUM_WORDS][j]) * 0x3D1;
+			if (i >= 1)
+				sum += product[i + Uint256::NUM_WORDS - 1][j];
+			out[i][j] = static_cast<uint32_t>(sum);
+			carry[j] = sum >> 32;
+		}
+		countOps(LANE_GROUP * 10 * arithmeticOps);
+	}
+	for (int j = 0; j < LANE_GROUP; j++)
+		top[j] = carry[j] + product[Uint256::NUM_WORDS * 2 - 1][j];
+	
+	// Fold the top word the same way. This can wrap past 2^256 at most once, leaving a small
+	// value, so one more fold of the final carry cannot overflow. Then reduce below the modulus.
+	for (int pass = 0; pass < 2; pass++) {
+		for (int j = 0; j < LANE_GROUP; j++)
+			carry[j] = 0;
+		for (int i = 0; i < Uint256::NUM_WORDS; i++) {
+			for (int j = 0; j < LANE_GROUP; j++) {
+				uint64_t sum = carry[j] + out[i][j];
+				if (i == 0)
+					sum += top[j] * 0x3D1;
+				else if (i == 1)
+					sum += top[j];
+				out[i][j] = static_cast<uint32_t>(sum);
+				carry[j] = sum >> 32;
+			}
+			countOps(LANE_GROUP * 8 * arithmeticOps);
+		}
+		for (int j = 0; j < LANE_GROUP; j++)
+			top[j] = carry[j];
+	}
+	uint32_t noCarry[LANE_GROUP] = {};
+	for (int j = 0; j < LANE_GROUP; j++)
+		assert(top[j] == 0);
+	reduceOnce(out, noCarry);
+}
+
+
+void PointBatch::fieldMultiplyB3(FieldGroup &val) {
+	countOps(functionOps);
+	FieldGroup temp;
+	fieldAdd(temp, val, val);  // 2
+	fieldAdd(temp, temp, temp);  // 4
+	fieldAdd(val, temp, val);  // 5
+	fieldAdd(temp, temp, temp);  // 8
+	fieldAdd(temp, temp, temp);  // 16
+	fieldAdd(val, temp, val);  // 21
+}
+
+
+void PointBatch::reduceOnce(FieldGroup &val, const uint32_t carry[LANE_GROUP]) {
+	countOps(functionOps);
+	FieldGroup diff;
+	uint32_t borrow[LANE_GROUP] = {};
+	for (int i = 0; i < Uint256::NUM_WORDS; i++) {
+		for (int j = 0; j < LANE_GROUP; j++) {
+			uint64_t d = static_cast<uint64_t>(val[i][j]) - MODULUS[i] - borrow[j];
+			diff[i][j] = static_cast<uint32_t>(d);
+			borrow[j] = -static_cast<uint32_t>(d >> 32);
+		}
+		countOps(LANE_GROUP * 9 * arithmeticOps);
+	}
+	uint32_t mask[LANE_GROUP];
+	for (int j = 0; j < LANE_GROUP; j++) {
+		assert((carry[j] >> 1) == 0 && (borrow[j] >> 1) == 0);
+		mask[j] = -(carry[j] | (borrow[j] ^ 1));
+	}
+	for (int i = 0; i < Uint256::NUM_WORDS; i++) {
+		for (int j = 0; j < LANE_GROUP; j++)
+			val[i][j] = (diff[i][j] & mask[j]) | (val[i][j] & ~mask[j]);
+		countOps(LANE_GROUP * 4 * arithmeticOps);
+	}
+}
+
+
+FieldInt PointBatch::getLane(const FieldGroup &src, int lane) {
+	FieldInt result = CurvePoint::FI_ZERO;
+	for (int i = 0; i < Uint256::NUM_WORDS; i++)
+		result.value[i] = src[i][lane];
+	return result;
+}
+
+
+void PointBatch::setLane(FieldGroup &dest, int lane, const FieldInt &val) {
+	for (int i = 0; i < Uint256::NUM_WORDS; i++)
+		dest[i][lane] = val.value[i];
+}
+
+
+// Static initializers
+const uint32_t PointBatch::MODULUS[Uint256::NUM_WORDS] = {
+	0xFFFFFC2F, 0xFFFFFFFE, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF, 0xFFFFFFFF,
+};
@@ -0,0 +1,174 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "CurvePoint.hpp"
+#include "FieldInt.hpp"
+#include "Uint256.hpp"
+
+
+/* 
+ * A fixed-capacity batch of secp256k1 points in projective coordinates, for bulk work such as address
+ * generation and batch verification. The coordinates are stored limb-sliced in blocks of LANE_GROUP points
+ * (word k of the x coordinates of a block's points is contiguous, and so on), 32-byte aligned. Each batched
+ * arithmetic method runs the same instruction sequence on every lane, which compilers can auto-vectorize.
+ * 
+ * Addition and doubling use the complete formulas of Renes, Costello, and Batina (2016) for a = 0, so there
+ * are no special cases to branch on; the projective representations differ from those produced by
+ * CurvePoint::add() and twice(), but they represent the same points. Instances are mutable. Example usage:
+ *   PointBatch batch(points, n);
+ *   batch.add(CurvePoint::G);
+ *   batch.normalize();
+ *   batch.toCompressedPoints(output);  // Needs normalize() first
+ */
+class PointBatch final {
+	
+	/*---- Public constants ----*/
+	
+	public: static constexpr int LANE_GROUP = 8;  // Points per block; one 256-bit vector holds a limb of each
+	public: static constexpr int CAPACITY = 64;  // Maximum number of points, a multiple of LANE_GROUP
+	
+	
+	
+	/*---- Types ----*/
+	
+	// One field element per lane, indexed by [word][lane]
+	private: typedef std::uint32_t FieldGroup[Uint256::NUM_WORDS][LANE_GROUP];
+	
+	private: struct alignas(32) Block {
+		FieldGroup x;
+		FieldGroup y;
+		FieldGroup z;
+	};
+	
+	
+	
+	/*---- Fields ----*/
+	
+	private: Block blocks[CAPACITY / LANE_GROUP];
+	private: int size;
+	
+	
+	
+	/*---- Constructors ----*/
+	
+	// Constructs a batch of n copies of CurvePoint::ZERO, where 0 <= n <= CAPACITY.
+	public: explicit PointBatch(int n);
+	
+	
+	// Constructs a batch holding a copy of the given n points, where 0 <= n <= CAPACITY.
+	public: explicit PointBatch(const CurvePoint points[], int n);
+	
+	
+	
+	/*---- Accessors ----*/
+	
+	// Returns the number of points in this batch.
+	public: int getSize() const;
+	
+	
+	// Returns a copy of the point at the given index. Constant-time with respect to the point value.
+	public: CurvePoint get(int index) const;
+	
+	
+	// Sets the point at the given index to a copy of the given point. Constant-time with respect to the point value.
+	public: void set(int index, const CurvePoint &pt);
+	
+	
+	
+	/*---- Batched arithmetic methods ----*/
+	
+	// Adds each point of the given batch (which must have the same size) into the point at the same index
+	// in this batch. The other batch can be this batch. Constant-time with respect to all the point values.
+	public: void add(const PointBatch &other);
+	
+	
+	// Adds the given point into every point of this batch. Constant-time with respect to all the point values.
+	public: void add(const CurvePoint &pt);
+	
+	
+	// Doubles every point of this batch. Constant-time with respect to all the point values.
+	public: void twice();
+	
+	
+	// Normalizes every point of this batch, with the same result as CurvePoint::normalize(). Uses Montgomery's
+	// trick, so there is only one field inversion for the whole batch. Constant-time with respect to the point values.
+	public: void normalize();
+	
+	
+	// Writes the 33-byte compressed encoding of each point to output[i]. All points must be normalized and not zero.
+	// Constant-time with respect to the point values.
+	public: void toCompressedPoints(std::uint8_t output[][33]) const;
+	
+	
+	// Writes the 65-byte uncompressed encoding of each point to output[i]. All points must be normalized and not zero.
+	// Constant-time with respect to the point values.
+	public: void toUncompressedPoints(std::uint8_t output[][65]) const;
+	
+	
+	
+	/*---- Static functions ----*/
+	
+	// Writes the 33-byte compressed public key of each private exponent privExps[i] to outKeys[i], for 0 <= i < n.
+	// Each point is computed by CurvePoint::multiplyGenerator(), so installing a generator table speeds this up,
+	// and each chunk of CAPACITY points shares one field inversion for normalization. The work is split into chunks
+	// across the given number of threads (1 means the calling thread only), and the output order always matches the
+	// input order. Requires 0 < privExps[i] < CurvePoint::ORDER. Constant-time with respect to the private exponents.
+	public: static void privateExponentsToCompressedKeys(const Uint256 privExps[], std::size_t n, std::uint8_t outKeys[][33], int numThreads);
+	
+	
+	// Handles the chunks with index congruent to first modulo step, for privateExponentsToCompressedKeys().
+	private: static void compressedKeysWorker(const Uint256 privExps[], std::size_t n, std::uint8_t outKeys[][33], std::size_t first, std::size_t step);
+	
+	
+	
+	/*---- Private helper functions ----*/
+	
+	// Sets p = p + q for every lane of the blocks, which can be the same object.
+	private: static void addBlock(Block &p, const Block &q);
+	
+	
+	// Sets p = 2 * p for every lane of the block.
+	private: static void twiceBlock(Block &p);
+	
+	
+	// Sets out = a + b (mod p) for every lane. The output can alias the inputs.
+	private: static void fieldAdd(FieldGroup &out, const FieldGroup &a, const FieldGroup &b);
+	
+	
+	// Sets out = a - b (mod p) for every lane. The output can alias the inputs.
+	private: static void fieldSubtract(FieldGroup &out, const FieldGroup &a, const FieldGroup &b);
+	
+	
+	// Sets out = a * b (mod p) for every lane. The output can alias the inputs.
+	private: static void fieldMultiply(FieldGroup &out, const FieldGroup &a, const FieldGroup &b);
+	
+	
+	// Multiplies every lane by 3b = 21, the constant in the complete formulas.
+	private: static void fieldMultiplyB3(FieldGroup &val);
+	
+	
+	// For every lane, subtracts the modulus if carry[lane] is 1 or val[lane] >= p.
+	// The value plus 2^256 * carry must be less than 2 * p.
+	private: static void reduceOnce(FieldGroup &val, const std::uint32_t carry[LANE_GROUP]);
+	
+	
+	private: static FieldInt getLane(const FieldGroup &src, int lane);
+	
+	private: static void setLane(FieldGroup &dest, int lane, const FieldInt &val);
+	
+	
+	
+	/*---- Class constants ----*/
+	
+	private: static const std::uint32_t MODULUS[Uint256::NUM_WORDS];  // The field prime, little endian
+	
+};
@@ -0,0 +1,220 @@
+/* 
+ * A runnable main program that tests the functionality of class PointBatch.
+ * 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include "TestHelper.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "CurvePoint.hpp"
+#include "PointBatch.hpp"
+#include "Uint256.hpp"
+
+using std::uint8_t;
+
+
+// Global variables
+static int numTestCases = 0;
+
+
+/*---- Helper functions ----*/
+
+// Returns a varied mix of points in unnormalized representations, including zero and some with large coordinates.
+static vector<CurvePoint> makePoints(int n) {
+	vector<CurvePoint> result;
+	CurvePoint p = CurvePoint::G;
+	for (int i = 0; i < n; i++) {
+		if (i % 7 == 3)
+			result.push_back(CurvePoint::ZERO);
+		else if (i % 5 == 1)
+			result.push_back(CurvePoint::privateExponentToPublicPoint(Uint256("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364140")));  // -G
+		else
+			result.push_back(p);
+		p.twice();
+		p.add(CurvePoint::G);
+	}
+	return result;
+}
+
+
+/*---- Test cases ----*/
+
+static void testAccessors() {
+	vector<CurvePoint> points = makePoints(13);
+	PointBatch batch(points.data(), static_cast<int>(points.size()));
+	assert(batch.getSize() == 13);
+	for (int i = 0; i < batch.getSize(); i++) {
+		CurvePoint p = batch.get(i);
+		assert(p.x == points[i].x && p.y == points[i].y && p.z == points[i].z);
+		numTestCases++;
+	}
+	batch.set(4, CurvePoint::G);
+	assert(batch.get(4) == CurvePoint::G && batch.get(5) == points[5]);
+	numTestCases++;
+	
+	PointBatch empty(0);
+	assert(empty.getSize() == 0);
+	empty.add(CurvePoint::G);
+	empty.twice();
+	empty.normalize();
+	numTestCases++;
+}
+
+
+static void testAdd() {
+	const int n = PointBatch::CAPACITY;
+	vector<CurvePoint> ps = makePoints(n);
+	vector<CurvePoint> qs = makePoints(n + 9);
+	qs.erase(qs.begin(), qs.begin() + 9);
+	qs[0] = ps[0];  // Doubling
+	CurvePoint neg = ps[1];
+	neg.negate();
+	qs[1] = neg;  // Inverse pair
+	qs[2] = CurvePoint::ZERO;
+	ps[10] = CurvePoint::ZERO;
+	qs[10] = CurvePoint::ZERO;
+	
+	PointBatch batch(ps.data(), n);
+	PointBatch other(qs.data(), n);
+	batch.add(other);
+	for (int i = 0; i < n; i++) {
+		CurvePoint expect = ps[i];
+		expect.add(qs[i]);
+		assert(batch.get(i) == expect);
+		numTestCases++;
+	}
+	
+	// Adding a batch to itself doubles it
+	PointBatch self(ps.data(), 11);
+	self.add(self);
+	for (int i = 0; i < 11; i++) {
+		CurvePoint expect = ps[i];
+		expect.twice();
+		assert(self.get(i) == expect);
+		numTestCases++;
+	}
+}
+
+
+static void testAddPoint() {
+	const int n = 21;
+	vector<CurvePoint> ps = makePoints(n);
+	PointBatch batch(ps.data(), n);
+	for (int round = 0; round < 3; round++) {
+		batch.add(CurvePoint::G);
+		for (int i = 0; i < n; i++) {
+			ps[i].add(CurvePoint::G);
+			assert(batch.get(i) == ps[i]);
+			numTestCases++;
+		}
+	}
+}
+
+
+static void testTwice() {
+	const int n = 30;
+	vector<CurvePoint> ps = makePoints(n);
+	PointBatch batch(ps.data(), n);
+	for (int round = 0; round < 3; round++) {
+		batch.twice();
+		for (int i = 0; i < n; i++) {
+			ps[i].twice();
+			assert(batch.get(i) == ps[i]);
+			numTestCases++;
+		}
+	}
+}
+
+
+static void testNormalizeAndSerialize() {
+	const int n = 45;
+	vector<CurvePoint> ps = makePoints(n);
+	PointBatch batch(ps.data(), n);
+	batch.add(CurvePoint::G);
+	batch.twice();
+	batch.normalize();
+	uint8_t compressed[n][33];
+	uint8_t uncompressed[n][65];
+	for (int i = 0; i < n; i++) {
+		CurvePoint expect = ps[i];
+		expect.add(CurvePoint::G);
+		expect.twice();
+		expect.normalize();
+		CurvePoint actual = batch.get(i);
+		assert(actual.x == expect.x && actual.y == expect.y && actual.z == expect.z);
+		numTestCases++;
+		// Serialization needs nonzero points
+		if (actual.isZero())
+			batch.set(i, CurvePoint::G);
+	}
+	
+	batch.toCompressedPoints(compressed);
+	batch.toUncompressedPoints(uncompressed);
+	for (int i = 0; i < n; i++) {
+		CurvePoint p = batch.get(i);
+		uint8_t expect[65];
+		p.toCompressedPoint(expect);
+		assert(std::memcmp(compressed[i], expect, 33) == 0);
+		p.toUncompressedPoint(expect);
+		assert(std::memcmp(uncompressed[i], expect, 65) == 0);
+		numTestCases++;
+	}
+}
+
+
+static void testPrivateExponentsToCompressedKeys() {
+	const size_t n = PointBatch::CAPACITY * 2 + 13;  // Two full chunks and a partial one
+	vector<Uint256> privExps;
+	Uint256 k("00000000000000000000000000000000000000000000000000000000000000FE");
+	const Uint256 step("9E3779B97F4A7C15F39CC0605CEDC8341082276BF3A27251F86C6A11D0C18E95");
+	for (size_t i = 0; i < n; i++) {
+		privExps.push_back(k);
+		k.add(step);
+		k.subtract(CurvePoint::ORDER, static_cast<std::uint32_t>(k >= CurvePoint::ORDER));
+	}
+	privExps[1] = Uint256::ONE;
+	privExps[2] = Uint256("FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364140");
+	
+	vector<Bytes> expect;
+	for (const Uint256 &privExp : privExps) {
+		Bytes key(33);
+		CurvePoint::privateExponentToPublicPoint(privExp).toCompressedPoint(key.data());
+		expect.push_back(key);
+	}
+	
+	vector<CurvePoint> genTable(CurvePoint::GENERATOR_TABLE_LEN, CurvePoint::ZERO);
+	CurvePoint::precomputeGeneratorTable(genTable.data());
+	const size_t lens[] = {0, 1, PointBatch::CAPACITY, n};
+	for (int useTable = 0; useTable < 2; useTable++) {
+		CurvePoint::setGeneratorTable(useTable != 0 ? genTable.data() : nullptr);
+		for (int numThreads : {1, 3}) {
+			for (size_t len : lens) {
+				vector<uint8_t> actual(n * 33 + 1, 0xAA);
+				PointBatch::privateExponentsToCompressedKeys(privExps.data(), len, reinterpret_cast<uint8_t (*)[33]>(actual.data()), numThreads);
+				for (size_t i = 0; i < len; i++)
+					assert(std::memcmp(&actual[i * 33], expect[i].data(), 33) == 0);
+				assert(actual[len * 33] == 0xAA);  // Nothing written past the end
+				numTestCases++;
+			}
+		}
+	}
+	CurvePoint::setGeneratorTable(nullptr);
+}
+
+
+int main() {
+	testAccessors();
+	testAdd();
+	testAddPoint();
+	testTwice();
+	testNormalizeAndSerialize();
+	testPrivateExponentsToCompressedKeys();
+	std::printf("All %d test cases passed\n", numTestCases);
+	return EXIT_SUCCESS;
+}
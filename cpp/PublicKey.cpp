@@ -0,0 +1,48 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include "PublicKey.hpp"
+
+
+PublicKey::PublicKey() :
+	point(CurvePoint::G) {}
+
+
+bool PublicKey::fromPoint(const CurvePoint &pt, PublicKey &outKey) {
+	CurvePoint p = pt;
+	if (p.z != CurvePoint::FI_ONE)
+		p.normalize();
+	if (!p.isOnCurve())  // Also rejects zero
+		return false;
+	outKey.point = p;
+	outKey.table.clear();
+	return true;
+}
+
+
+const CurvePoint &PublicKey::getPoint() const {
+	return point;
+}
+
+
+void PublicKey::precompute() {
+	if (!table.empty())
+		return;
+	table.assign(CurvePoint::PRECOMPUTED_TABLE_LEN, point);
+	CurvePoint::precomputeDoubleMultiplyTable(point, table.data());
+}
+
+
+bool PublicKey::hasPrecomputation() const {
+	return !table.empty();
+}
+
+
+const CurvePoint *PublicKey::getTable() const {
+	return table.empty() ? nullptr : table.data();
+}
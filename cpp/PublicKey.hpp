@@ -0,0 +1,66 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#pragma once
+
+#include <vector>
+#include "CurvePoint.hpp"
+
+
+/* 
+ * A public key that has been validated once, so that signature verification does not need to check it again.
+ * The point is always normalized, on the curve, and not zero. Because the secp256k1 cofactor is 1, every such
+ * point has order CurvePoint::ORDER, so no subgroup check is needed. Optionally holds a precomputed table of
+ * multiples of the point, which speeds up each later verification against the same key. Instances are
+ * mutable only through precompute() and assignment, and are safe to read from multiple threads.
+ */
+class PublicKey final {
+	
+	/*---- Fields ----*/
+	
+	private: CurvePoint point;
+	private: std::vector<CurvePoint> table;  // Empty, or CurvePoint::PRECOMPUTED_TABLE_LEN entries
+	
+	
+	
+	/*---- Constructors ----*/
+	
+	// Constructs a public key holding the base point G, which is mainly
+	// useful as a placeholder value to be overwritten by fromPoint().
+	public: explicit PublicKey();
+	
+	
+	
+	/*---- Static factory functions ----*/
+	
+	// Validates the given point, which can be in any projective representation. If it is on the curve and not zero,
+	// then the output key is set to its normalized value without precomputation, and true is returned. Otherwise
+	// the output key is unchanged, and false is returned. Not constant-time.
+	public: static bool fromPoint(const CurvePoint &pt, PublicKey &outKey);
+	
+	
+	
+	/*---- Methods ----*/
+	
+	// Returns the normalized point of this public key.
+	public: const CurvePoint &getPoint() const;
+	
+	
+	// Computes and stores the table of multiples of this key used by Ecdsa::verify(). This allocates
+	// CurvePoint::PRECOMPUTED_TABLE_LEN points, and does nothing if the table already exists. Not constant-time.
+	public: void precompute();
+	
+	
+	// Returns whether precompute() has been called on this key (or the key it was copied from).
+	public: bool hasPrecomputation() const;
+	
+	
+	// Returns a pointer to the precomputed table, or null if there is none.
+	public: const CurvePoint *getTable() const;
+	
+};
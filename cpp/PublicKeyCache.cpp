@@ -0,0 +1,141 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include <iterator>
+#include "PublicKeyCache.hpp"
+
+using std::size_t;
+using std::uint64_t;
+
+
+PublicKeyCache::PublicKeyCache(size_t memLimit) :
+	memoryLimit(memLimit),
+	hits(0),
+	misses(0) {}
+
+
+std::shared_ptr<const PublicKey> PublicKeyCache::get(const CurvePoint &pt) {
+	KeyBytes bytes;
+	pt.toCompressedPoint(bytes.data());
+	std::shared_ptr<const PublicKey> unprecomputed;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		auto it = index.find(bytes);
+		// An invalid point can share its compressed encoding with a valid one, so compare the whole point
+		if (it != index.end() && it->second->key->getPoint() == pt) {
+			hits++;
+			std::list<Entry>::iterator entry = it->second;
+			if (!entry->key->hasPrecomputation()) {
+				if (entry->isBuilding)  // Another thread is building the table, so don't wait for it
+					return entry->key;
+				entry->isBuilding = true;
+				unprecomputed = entry->key;
+			} else {
+				std::shared_ptr<const PublicKey> result = entry->key;
+				promote(entry);
+				return result;
+			}
+		}
+	}
+	
+	if (unprecomputed != nullptr) {
+		// Second sighting: precompute the table without holding the lock
+		std::shared_ptr<PublicKey> key = std::make_shared<PublicKey>(*unprecomputed);
+		key->precompute();
+		std::lock_guard<std::mutex> lock(mutex);
+		auto it = index.find(bytes);
+		if (it != index.end() && it->second->key == unprecomputed) {  // Not evicted or replaced meanwhile
+			it->second->key = key;
+			it->second->isBuilding = false;
+			promote(it->second);
+		}
+		return key;
+	}
+	misses++;
+	
+	// Validate without holding the lock
+	std::shared_ptr<PublicKey> key = std::make_shared<PublicKey>();
+	if (pt.z != CurvePoint::FI_ONE || !PublicKey::fromPoint(pt, *key))
+		return nullptr;
+	
+	std::lock_guard<std::mutex> lock(mutex);
+	auto it = index.find(bytes);
+	if (it != index.end())  // Another thread inserted the same key meanwhile
+		return it->second->key;
+	probationaryEntries.push_front(Entry{bytes, key, false, false});
+	index[bytes] = probationaryEntries.begin();
+	evict();
+	return key;
+}
+
+
+void PublicKeyCache::setMemoryLimit(size_t memLimit) {
+	std::lock_guard<std::mutex> lock(mutex);
+	memoryLimit = memLimit;
+	evict();
+}
+
+
+size_t PublicKeyCache::getMemoryLimit() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return memoryLimit;
+}
+
+
+size_t PublicKeyCache::getSize() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return index.size();
+}
+
+
+uint64_t PublicKeyCache::getHits() const {
+	return hits.load();
+}
+
+
+uint64_t PublicKeyCache::getMisses() const {
+	return misses.load();
+}
+
+
+void PublicKeyCache::clear() {
+	std::lock_guard<std::mutex> lock(mutex);
+	index.clear();
+	protectedEntries.clear();
+	probationaryEntries.clear();
+}
+
+
+void PublicKeyCache::promote(std::list<Entry>::iterator entry) {
+	protectedEntries.splice(protectedEntries.begin(), entry->isProtected ? protectedEntries : probationaryEntries, entry);
+	entry->isProtected = true;
+	evict();
+}
+
+
+void PublicKeyCache::evict() {
+	size_t maxEntries = memoryLimit / ENTRY_SIZE;
+	size_t maxProtected = maxEntries * PROTECTED_PERCENT / 100;
+	while (protectedEntries.size() > maxProtected) {
+		std::list<Entry>::iterator last = std::prev(protectedEntries.end());
+		last->isProtected = false;
+		probationaryEntries.splice(probationaryEntries.begin(), protectedEntries, last);
+	}
+	while (index.size() > maxEntries) {
+		std::list<Entry> &victims = !probationaryEntries.empty() ? probationaryEntries : protectedEntries;
+		index.erase(victims.back().bytes);
+		victims.pop_back();
+	}
+}
+
+
+// Static initializers
+const size_t PublicKeyCache::ENTRY_SIZE =
+	sizeof(PublicKey) + CurvePoint::PRECOMPUTED_TABLE_LEN * sizeof(CurvePoint)  // Key and table
+	+ sizeof(Entry) + sizeof(KeyBytes) + sizeof(std::list<Entry>::iterator)    // List and map payloads
+	+ 6 * sizeof(void *);                                                       // Node and control block overhead
@@ -0,0 +1,125 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <list>
+#include <map>
+#include <memory>
+#include <mutex>
+#include "CurvePoint.hpp"
+#include "PublicKey.hpp"
+
+
+/* 
+ * A bounded, thread-safe cache of validated public keys, keyed by the 33-byte compressed encoding of the
+ * point. Useful when a small set of keys appears in many signatures. Install one with Ecdsa::setPublicKeyCache()
+ * to have Ecdsa::verify() consult it automatically. All methods may be called concurrently.
+ * 
+ * A key seen for the first time is cached without a verification table. Building the table costs about 2.24M
+ * field operations (36% of a plain verification), and each verification with it saves about 0.69M (11%), so the
+ * table breaks even after about four uses. It is therefore built only when a key is seen a second time, which is
+ * the first sign that the key is reused, and never for keys seen only once. Keys that
+ * have been seen more than once live in a protected segment of at most 80% of the capacity, and the least
+ * recently used probationary keys are evicted first, so a stream of one-off keys (for example from an attacker)
+ * can neither force table builds nor flush the keys that are actually reused.
+ */
+class PublicKeyCache final {
+	
+	/*---- Fields ----*/
+	
+	private: using KeyBytes = std::array<std::uint8_t, 33>;
+	
+	private: struct Entry {
+		KeyBytes bytes;
+		std::shared_ptr<const PublicKey> key;
+		bool isProtected;
+		bool isBuilding;  // A thread is precomputing the table for this key
+	};
+	
+	private: mutable std::mutex mutex;
+	private: std::list<Entry> protectedEntries;     // Keys seen more than once, most recently used first
+	private: std::list<Entry> probationaryEntries;  // Keys seen once or demoted, most recently used first
+	private: std::map<KeyBytes, std::list<Entry>::iterator> index;
+	private: std::size_t memoryLimit;
+	
+	private: std::atomic<std::uint64_t> hits;
+	private: std::atomic<std::uint64_t> misses;
+	
+	
+	
+	/*---- Constructors ----*/
+	
+	// Constructs an empty cache that holds at most memoryLimit / ENTRY_SIZE keys.
+	public: explicit PublicKeyCache(std::size_t memLimit);
+	
+	
+	PublicKeyCache(const PublicKeyCache &) = delete;
+	PublicKeyCache &operator=(const PublicKeyCache &) = delete;
+	
+	
+	
+	/*---- Methods ----*/
+	
+	// Returns the cached key for the given normalized point, or validates the point and inserts it as a
+	// probationary key without a table if it is absent (evicting keys to stay within the memory limit). On
+	// the second sighting of a key, its table is precomputed and the key is moved to the protected segment;
+	// only one thread builds a key's table, and other threads get the key without a table until it is installed.
+	// Returns null if the point is not a valid public key; invalid points are never cached. The returned key
+	// stays usable after eviction. The expensive work is done without holding the lock. Not constant-time.
+	public: std::shared_ptr<const PublicKey> get(const CurvePoint &pt);
+	
+	
+	// Changes the memory limit, evicting the least recently used keys if necessary.
+	public: void setMemoryLimit(std::size_t memLimit);
+	
+	
+	public: std::size_t getMemoryLimit() const;
+	
+	
+	// Returns the number of keys currently cached.
+	public: std::size_t getSize() const;
+	
+	
+	// Returns the number of get() calls that found the key already cached.
+	public: std::uint64_t getHits() const;
+	
+	
+	// Returns the number of get() calls that did not find the key cached (including invalid points).
+	public: std::uint64_t getMisses() const;
+	
+	
+	// Removes all keys, but leaves the counters unchanged.
+	public: void clear();
+	
+	
+	// Moves the given entry to the front of the protected segment. Requires the lock to be held.
+	private: void promote(std::list<Entry>::iterator entry);
+	
+	
+	// Demotes least recently used protected entries to probation until that segment fits its share, then
+	// removes least recently used entries (probationary first) until the count fits the memory limit.
+	// Requires the lock to be held.
+	private: void evict();
+	
+	
+	
+	/*---- Class constants ----*/
+	
+	// Approximate number of bytes used by each cached key, including its precomputed table and bookkeeping.
+	// Probationary keys have no table yet, but are budgeted at the same size.
+	public: static const std::size_t ENTRY_SIZE;
+	
+	// Percentage of the capacity that keys seen more than once may occupy.
+	private: static constexpr int PROTECTED_PERCENT = 80;
+	
+};
@@ -0,0 +1,226 @@
+/* 
+ * A runnable main program that tests the functionality of class PublicKeyCache.
+ * 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include "TestHelper.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include <vector>
+#include "CurvePoint.hpp"
+#include "Ecdsa.hpp"
+#include "PublicKeyCache.hpp"
+#include "Sha256.hpp"
+#include "Sha256Hash.hpp"
+#include "Uint256.hpp"
+
+using std::uint8_t;
+using std::uint64_t;
+
+
+// Global variables
+static int numTestCases = 0;
+
+
+// Returns the public point for the small private key k.
+static CurvePoint smallKey(uint8_t k) {
+	uint8_t bytes[Uint256::NUM_WORDS * 4] = {};
+	bytes[sizeof(bytes) - 1] = k;
+	return CurvePoint::privateExponentToPublicPoint(Uint256(bytes));
+}
+
+
+/*---- Test cases ----*/
+
+static void testPromotion() {
+	PublicKeyCache cache(3 * PublicKeyCache::ENTRY_SIZE);
+	for (uint8_t k = 1; k <= 3; k++) {
+		std::shared_ptr<const PublicKey> key = cache.get(smallKey(k));
+		assert(key != nullptr && !key->hasPrecomputation() && key->getPoint() == smallKey(k));
+	}
+	assert(cache.getSize() == 3 && cache.getHits() == 0 && cache.getMisses() == 3);
+	numTestCases++;
+	
+	// The second sighting builds the table, later ones reuse it
+	std::shared_ptr<const PublicKey> key = cache.get(smallKey(1));
+	assert(key != nullptr && key->hasPrecomputation() && key->getPoint() == smallKey(1));
+	assert(cache.get(smallKey(1)) == key);
+	assert(cache.getSize() == 3 && cache.getHits() == 2 && cache.getMisses() == 3);
+	numTestCases++;
+	
+	// A new key evicts the least recently used probationary key, not the protected one
+	assert(cache.get(smallKey(4)) != nullptr);  // Evicts key 2
+	assert(cache.getSize() == 3 && cache.getMisses() == 4);
+	assert(cache.get(smallKey(1)) == key && cache.get(smallKey(3)) != nullptr && cache.get(smallKey(4)) != nullptr);
+	assert(cache.getHits() == 5 && cache.getMisses() == 4);
+	assert(cache.get(smallKey(2)) != nullptr);
+	assert(cache.getHits() == 5 && cache.getMisses() == 5);
+	numTestCases++;
+}
+
+
+static void testConcurrentPromotion() {
+	// Many threads see a key for the second time at once; only one of them builds its table
+	for (int round = 0; round < 10; round++) {
+		PublicKeyCache cache(4 * PublicKeyCache::ENTRY_SIZE);
+		const CurvePoint pt = smallKey(static_cast<uint8_t>(round + 1));
+		assert(cache.get(pt) != nullptr);
+		const int numThreads = 8;
+		std::shared_ptr<const PublicKey> results[numThreads];
+		std::vector<std::thread> threads;
+		for (int t = 0; t < numThreads; t++)
+			threads.emplace_back([&cache, &pt, &results, t]() { results[t] = cache.get(pt); });
+		for (std::thread &th : threads)
+			th.join();
+		std::shared_ptr<const PublicKey> key = cache.get(pt);
+		assert(key->hasPrecomputation());
+		for (const std::shared_ptr<const PublicKey> &result : results) {
+			assert(result != nullptr && result->getPoint() == pt);
+			assert(!result->hasPrecomputation() || result == key);  // No second table was built
+		}
+		assert(cache.getHits() == numThreads + 1 && cache.getMisses() == 1);
+		numTestCases++;
+	}
+}
+
+
+static void testChurnResistance() {
+	PublicKeyCache cache(5 * PublicKeyCache::ENTRY_SIZE);
+	for (int i = 0; i < 2; i++) {
+		for (uint8_t k = 1; k <= 4; k++)
+			cache.get(smallKey(k));
+	}
+	for (uint8_t k = 10; k < 60; k++) {  // One-off keys
+		std::shared_ptr<const PublicKey> key = cache.get(smallKey(k));
+		assert(key != nullptr && !key->hasPrecomputation());
+	}
+	assert(cache.getSize() == 5 && cache.getHits() == 4 && cache.getMisses() == 54);
+	for (uint8_t k = 1; k <= 4; k++) {
+		std::shared_ptr<const PublicKey> key = cache.get(smallKey(k));
+		assert(key != nullptr && key->hasPrecomputation());
+	}
+	assert(cache.getHits() == 8 && cache.getMisses() == 54);
+	numTestCases++;
+	
+	// Protected keys beyond their share are demoted, then evicted like probationary ones
+	cache.get(smallKey(10));
+	cache.get(smallKey(10));
+	assert(cache.getSize() == 5 && cache.get(smallKey(10))->hasPrecomputation());
+	for (uint8_t k = 60; k < 62; k++)
+		cache.get(smallKey(k));
+	assert(cache.getSize() == 5);
+	uint64_t misses = cache.getMisses();
+	cache.get(smallKey(1));  // Was the least recently used protected key
+	assert(cache.getMisses() == misses + 1);
+	numTestCases++;
+}
+
+
+static void testInvalidPoints() {
+	PublicKeyCache cache(10 * PublicKeyCache::ENTRY_SIZE);
+	assert(cache.get(CurvePoint::G) != nullptr);
+	
+	// Same compressed encoding as G, but not on the curve
+	FieldInt y = CurvePoint::G.y;
+	y.add(FieldInt("0000000000000000000000000000000000000000000000000000000000000002"));
+	const CurvePoint invalids[] = {
+		CurvePoint(CurvePoint::G.x, y),
+		CurvePoint::ZERO,
+	};
+	for (const CurvePoint &pt : invalids) {
+		assert(cache.get(pt) == nullptr);
+		numTestCases++;
+	}
+	assert(cache.getSize() == 1 && cache.getHits() == 0 && cache.getMisses() == 3);
+	numTestCases++;
+}
+
+
+static void testMemoryLimit() {
+	PublicKeyCache cache(5 * PublicKeyCache::ENTRY_SIZE);
+	for (uint8_t k = 1; k <= 5; k++)
+		cache.get(smallKey(k));
+	assert(cache.getSize() == 5);
+	cache.setMemoryLimit(2 * PublicKeyCache::ENTRY_SIZE + 1);
+	assert(cache.getSize() == 2 && cache.getMemoryLimit() == 2 * PublicKeyCache::ENTRY_SIZE + 1);
+	assert(cache.get(smallKey(5)) != nullptr && cache.get(smallKey(4)) != nullptr);
+	assert(cache.getHits() == 2);
+	numTestCases++;
+	
+	cache.setMemoryLimit(0);
+	assert(cache.getSize() == 0);
+	std::shared_ptr<const PublicKey> key = cache.get(smallKey(1));  // Usable but not retained
+	assert(key != nullptr && cache.getSize() == 0);
+	numTestCases++;
+	
+	cache.setMemoryLimit(PublicKeyCache::ENTRY_SIZE);
+	cache.get(smallKey(1));
+	cache.clear();
+	assert(cache.getSize() == 0);
+	numTestCases++;
+}
+
+
+static void testVerifyWithCache() {
+	PublicKeyCache cache(2 * PublicKeyCache::ENTRY_SIZE);
+	Ecdsa::setPublicKeyCache(&cache);
+	
+	constexpr int numKeys = 3;
+	constexpr int numMsgs = 8;
+	vector<std::thread> threads;
+	bool failed[4] = {};
+	for (int t = 0; t < 4; t++) {
+		threads.push_back(std::thread([t, &failed]() {
+			for (int i = 0; i < numKeys * numMsgs; i++) {
+				uint8_t k = static_cast<uint8_t>(i % numKeys + 1);
+				uint8_t privBytes[Uint256::NUM_WORDS * 4] = {};
+				privBytes[sizeof(privBytes) - 1] = k;
+				const uint8_t msg[] = {static_cast<uint8_t>(i), static_cast<uint8_t>(t)};
+				const Sha256Hash msgHash = Sha256::getHash(msg, sizeof(msg));
+				Uint256 r, s;
+				if (!Ecdsa::signWithHmacNonce(Uint256(privBytes), msgHash, r, s))
+					failed[t] = true;
+				if (!Ecdsa::verify(smallKey(k), msgHash, r, s))
+					failed[t] = true;
+				r.add(Uint256::ONE);
+				if (Ecdsa::verify(smallKey(k), msgHash, r, s))
+					failed[t] = true;
+			}
+		}));
+	}
+	for (std::thread &th : threads)
+		th.join();
+	for (bool f : failed)
+		assert(!f);
+	assert(cache.getHits() + cache.getMisses() == 4 * 2 * numKeys * numMsgs);
+	assert(cache.getHits() > 0 && cache.getSize() <= 2);
+	assert(!Ecdsa::verify(CurvePoint::ZERO, Sha256::getHash(nullptr, 0), Uint256::ONE, Uint256::ONE));
+	numTestCases++;
+	
+	Ecdsa::setPublicKeyCache(nullptr);
+	uint64_t total = cache.getHits() + cache.getMisses();
+	Uint256 r, s;
+	const Sha256Hash msgHash = Sha256::getHash(nullptr, 0);
+	assert(Ecdsa::signWithHmacNonce(Uint256::ONE, msgHash, r, s));
+	assert(Ecdsa::verify(CurvePoint::G, msgHash, r, s));
+	assert(cache.getHits() + cache.getMisses() == total);
+	numTestCases++;
+}
+
+
+int main() {
+	testPromotion();
+	testConcurrentPromotion();
+	testChurnResistance();
+	testInvalidPoints();
+	testMemoryLimit();
+	testVerifyWithCache();
+	std::printf("All %d test cases passed\n", numTestCases);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,111 @@
+/* 
+ * A runnable main program that tests the functionality of class PublicKey.
+ * 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include "TestHelper.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include "CurvePoint.hpp"
+#include "Ecdsa.hpp"
+#include "PublicKey.hpp"
+#include "Sha256.hpp"
+#include "Sha256Hash.hpp"
+#include "Uint256.hpp"
+
+
+// Global variables
+static int numTestCases = 0;
+
+
+/*---- Test cases ----*/
+
+static void testFromPoint() {
+	// Valid normalized point
+	PublicKey key;
+	CurvePoint p = CurvePoint::G;
+	p.twice();
+	p.normalize();
+	assert(PublicKey::fromPoint(p, key));
+	assert(key.getPoint() == p && !key.hasPrecomputation() && key.getTable() == nullptr);
+	numTestCases++;
+	
+	// Valid point in an unnormalized representation
+	CurvePoint q = CurvePoint::G;
+	q.twice();
+	q.twice();
+	assert(PublicKey::fromPoint(q, key));
+	q.normalize();
+	assert(key.getPoint() == q);
+	numTestCases++;
+	
+	// Invalid points leave the key unchanged
+	const CurvePoint invalids[] = {
+		CurvePoint::ZERO,
+		CurvePoint("79BE667EF9DCBBAC55A06295CE870B07029BFCDB2DCE28D959F2815B16F81798", "483ADA7726A3C4655DA4FBFC0E1108A8FD17B448A68554199C47D08FFB10D4B9"),
+		CurvePoint("0000000000000000000000000000000000000000000000000000000000000000", "0000000000000000000000000000000000000000000000000000000000000000"),
+	};
+	for (const CurvePoint &pt : invalids) {
+		assert(!PublicKey::fromPoint(pt, key));
+		assert(key.getPoint() == q);
+		numTestCases++;
+	}
+}
+
+
+static void testPrecompute() {
+	PublicKey key;
+	assert(PublicKey::fromPoint(CurvePoint::privateExponentToPublicPoint(Uint256("C0FFEE0000000000000000000000000000000000000000000000000000000001")), key));
+	PublicKey precomp = key;
+	precomp.precompute();
+	assert(precomp.hasPrecomputation() && precomp.getTable() != nullptr && precomp.getPoint() == key.getPoint());
+	const CurvePoint *table = precomp.getTable();
+	precomp.precompute();  // Idempotent
+	assert(precomp.getTable() == table);
+	numTestCases++;
+	
+	// Precomputation survives copying but not reassignment by fromPoint()
+	PublicKey copy = precomp;
+	assert(copy.hasPrecomputation());
+	assert(PublicKey::fromPoint(CurvePoint::G, copy) && !copy.hasPrecomputation());
+	numTestCases++;
+}
+
+
+static void testVerify() {
+	const Uint256 privKey("C0FFEE0000000000000000000000000000000000000000000000000000000001");
+	PublicKey key;
+	assert(PublicKey::fromPoint(CurvePoint::privateExponentToPublicPoint(privKey), key));
+	PublicKey precomp = key;
+	precomp.precompute();
+	
+	for (int i = 0; i < 30; i++) {
+		const std::uint8_t msg[] = {static_cast<std::uint8_t>(i)};
+		const Sha256Hash msgHash = Sha256::getHash(msg, sizeof(msg));
+		Uint256 r, s;
+		assert(Ecdsa::signWithHmacNonce(privKey, msgHash, r, s));
+		if (i % 3 == 1)
+			s.add(Uint256::ONE);
+		else if (i % 3 == 2)
+			r = s;
+		bool expect = Ecdsa::verify(key.getPoint(), msgHash, r, s);
+		assert(expect == (i % 3 == 0));
+		assert(Ecdsa::verify(key, msgHash, r, s) == expect);
+		assert(Ecdsa::verify(precomp, msgHash, r, s) == expect);
+		numTestCases++;
+	}
+}
+
+
+int main() {
+	testFromPoint();
+	testPrecompute();
+	testVerify();
+	std::printf("All %d test cases passed\n", numTestCases);
+	return EXIT_SUCCESS;
+}
@@ -0,0 +1,133 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include <cassert>
+#include <cstring>
+#include <type_traits>
+#include "CurvePoint.hpp"
+#include "Rfc6979.hpp"
+#include "Utils.hpp"
+
+using std::size_t;
+using std::uint8_t;
+using std::uint32_t;
+
+
+Rfc6979::Rfc6979(const Uint256 &privateKey, const Sha256Hash &msgHash, const uint8_t extra[], size_t extraLen) :
+		hmacInner(ZERO_KEY_INNER),
+		hmacOuter(ZERO_KEY_OUTER),
+		hasOutput(false) {
+	/* 
+	 * Algorithm pseudocode (RFC 6979 section 3.2, steps b to g):
+	 * V = 0x01 0x01 ... 0x01
+	 * K = 0x00 0x00 ... 0x00
+	 * K = HMAC_K(V || 0x00 || int2octets(x) || bits2octets(h1) || extra)
+	 * V = HMAC_K(V)
+	 * K = HMAC_K(V || 0x01 || int2octets(x) || bits2octets(h1) || extra)
+	 * V = HMAC_K(V)
+	 */
+	assert(extra != nullptr || extraLen == 0);
+	const Uint256 &order = CurvePoint::ORDER;
+	assert(Uint256::ZERO < privateKey && privateKey < order);
+	uint8_t keyBytes[Uint256::NUM_WORDS * 4];
+	privateKey.getBigEndianBytes(keyBytes);
+	Uint256 z(msgHash.value);
+	z.subtract(order, static_cast<uint32_t>(z >= order));
+	uint8_t hashBytes[Uint256::NUM_WORDS * 4];
+	z.getBigEndianBytes(hashBytes);
+	
+	std::memset(v, 0x01, sizeof(v));
+	for (uint8_t sep = 0x00; sep <= 0x01; sep++) {
+		Sha256 inner = hmacInner;
+		inner.append(v, sizeof(v))
+			.append(&sep, 1)
+			.append(keyBytes, sizeof(keyBytes))
+			.append(hashBytes, sizeof(hashBytes))
+			.append(extra, extraLen);
+		uint8_t k[Sha256Hash::HASH_LEN];
+		finishHmac(inner, k);
+		setKey(k);
+		updateV();
+		Utils::secureZero(&inner, sizeof(inner));
+		Utils::secureZero(k, sizeof(k));
+	}
+	Utils::secureZero(keyBytes, sizeof(keyBytes));
+}
+
+
+Rfc6979::~Rfc6979() {
+	static_assert(std::is_trivially_copyable<Sha256>::value, "Must be overwritable as bytes");
+	Utils::secureZero(&hmacInner, sizeof(hmacInner));
+	Utils::secureZero(&hmacOuter, sizeof(hmacOuter));
+	Utils::secureZero(v, sizeof(v));
+}
+
+
+Uint256 Rfc6979::next() {
+	/* 
+	 * Algorithm pseudocode (RFC 6979 section 3.2, step h):
+	 * if (a nonce was already returned) {
+	 *   K = HMAC_K(V || 0x00)
+	 *   V = HMAC_K(V)
+	 * }
+	 * loop {
+	 *   V = HMAC_K(V)
+	 *   k = bits2int(V)
+	 *   if (k in range [1, order-1]) return k
+	 *   K = HMAC_K(V || 0x00)
+	 *   V = HMAC_K(V)
+	 * }
+	 */
+	const Uint256 &order = CurvePoint::ORDER;
+	for (bool update = hasOutput; ; update = true) {
+		if (update) {
+			Sha256 inner = hmacInner;
+			const uint8_t sep = 0x00;
+			inner.append(v, sizeof(v)).append(&sep, 1);
+			uint8_t k[Sha256Hash::HASH_LEN];
+			finishHmac(inner, k);
+			setKey(k);
+			updateV();
+			Utils::secureZero(&inner, sizeof(inner));
+			Utils::secureZero(k, sizeof(k));
+		}
+		updateV();
+		const Uint256 result(v);
+		if (Uint256::ZERO < result && result < order) {
+			hasOutput = true;
+			return result;
+		}
+	}
+}
+
+
+void Rfc6979::setKey(const uint8_t key[Sha256Hash::HASH_LEN]) {
+	hmacInner = Sha256::getHmacKeyedHasher(key, Sha256Hash::HASH_LEN, 0x36);
+	hmacOuter = Sha256::getHmacKeyedHasher(key, Sha256Hash::HASH_LEN, 0x5C);
+}
+
+
+void Rfc6979::updateV() {
+	Sha256 inner = hmacInner;
+	inner.append(v, sizeof(v));
+	finishHmac(inner, v);
+}
+
+
+void Rfc6979::finishHmac(Sha256 &inner, uint8_t out[Sha256Hash::HASH_LEN]) const {
+	const Sha256Hash innerHash = inner.getHash();
+	Sha256 outer = hmacOuter;
+	const Sha256Hash result = outer.append(innerHash.value, Sha256Hash::HASH_LEN).getHash();
+	std::memcpy(out, result.value, Sha256Hash::HASH_LEN);
+}
+
+
+// Static initializers
+static const uint8_t ZERO_KEY[Sha256Hash::HASH_LEN] = {};
+const Sha256 Rfc6979::ZERO_KEY_INNER = Sha256::getHmacKeyedHasher(ZERO_KEY, sizeof(ZERO_KEY), 0x36);
+const Sha256 Rfc6979::ZERO_KEY_OUTER = Sha256::getHmacKeyedHasher(ZERO_KEY, sizeof(ZERO_KEY), 0x5C);
@@ -0,0 +1,81 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#pragma once
+
+#include <cstddef>
+#include <cstdint>
+#include "Sha256.hpp"
+#include "Sha256Hash.hpp"
+#include "Uint256.hpp"
+
+
+/* 
+ * Generates deterministic ECDSA nonces for secp256k1 by the HMAC-DRBG procedure of RFC 6979 section 3.2 with
+ * HMAC-SHA-256, optionally mixing in extra data (the k' of section 3.6) after the message hash. The first nonce
+ * matches other RFC 6979 implementations (such as libsecp256k1 without extra data), and each further call
+ * continues the same generator, which is the retry path when a signature attempt fails.
+ * 
+ * The HMAC key K changes only a few times, so the hasher states after absorbing the padded inner and outer
+ * key blocks are kept for the current key; each HMAC then costs 2 compressions instead of 4 for a short
+ * message. The states for the initial all-zero key are shared class constants. Instances hold secret state,
+ * which the destructor erases, and are mutable. Example usage:
+ *   Rfc6979 gen(privKey, msgHash);
+ *   while (!Ecdsa::sign(privKey, msgHash, gen.next(), r, s));
+ */
+class Rfc6979 final {
+	
+	/*---- Fields ----*/
+	
+	private: Sha256 hmacInner;  // Has absorbed the current key K XOR 0x36
+	private: Sha256 hmacOuter;  // Has absorbed the current key K XOR 0x5C
+	private: std::uint8_t v[Sha256Hash::HASH_LEN];
+	private: bool hasOutput;  // Whether next() has returned a value, so the state must be updated first
+	
+	
+	
+	/*---- Constructors ----*/
+	
+	// Constructs a generator for the given private key, which must be in the range [1, CurvePoint::ORDER),
+	// and message hash (whose big-endian value is reduced modulo the order, as bits2octets does), mixing in
+	// the given extra bytes (which can be null if extraLen is 0). Constant-time with respect to the inputs.
+	public: explicit Rfc6979(const Uint256 &privateKey, const Sha256Hash &msgHash,
+		const std::uint8_t extra[] = nullptr, std::size_t extraLen = 0);
+	
+	
+	// Zeroizes the HMAC states and V.
+	public: ~Rfc6979();
+	
+	
+	
+	/*---- Methods ----*/
+	
+	// Returns the next nonce, which is in the range [1, CurvePoint::ORDER). Constant-time with respect to the
+	// state, except for how many candidates were rejected (each with probability below 2^-127).
+	public: Uint256 next();
+	
+	
+	// Sets hmacInner and hmacOuter to the states for the given 32-byte key.
+	private: void setKey(const std::uint8_t key[Sha256Hash::HASH_LEN]);
+	
+	
+	// Sets v = HMAC_K(v), using the current key.
+	private: void updateV();
+	
+	
+	// Finishes the HMAC whose message was appended to the given copy of hmacInner, and writes the result to out.
+	private: void finishHmac(Sha256 &inner, std::uint8_t out[Sha256Hash::HASH_LEN]) const;
+	
+	
+	
+	/*---- Class constants ----*/
+	
+	private: static const Sha256 ZERO_KEY_INNER;
+	private: static const Sha256 ZERO_KEY_OUTER;
+	
+};
@@ -0,0 +1,116 @@
+/* 
+ * A runnable main program that tests the functionality of class Rfc6979.
+ * 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include "TestHelper.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <cstring>
+#include "CurvePoint.hpp"
+#include "Ecdsa.hpp"
+#include "Rfc6979.hpp"
+#include "Sha256.hpp"
+#include "Sha256Hash.hpp"
+#include "Uint256.hpp"
+
+using std::uint8_t;
+
+
+// Global variables
+static int numTestCases = 0;
+
+
+/*---- Helper functions ----*/
+
+static Sha256Hash hashString(const char *msg) {
+	return Sha256::getHash(reinterpret_cast<const uint8_t *>(msg), std::strlen(msg));
+}
+
+
+/*---- Test cases ----*/
+
+static void testKnownNonces() {
+	struct TestCase {
+		const char *privateKey;
+		const char *message;
+		const char *nonce;
+	};
+	const vector<TestCase> cases{
+		{"0000000000000000000000000000000000000000000000000000000000000001", "Satoshi Nakamoto", "8F8A276C19F4149656B280621E358CCE24F5F52542772691EE69063B74F15D15"},
+		{"0000000000000000000000000000000000000000000000000000000000000001", "All those moments will be lost in time, like tears in rain. Time to die...", "38AA22D72376B4DBC472E06C3BA403EE0A394DA63FC58D88686C611ABA98D6B3"},
+		{"FFFFFFFFFFFFFFFFFFFFFFFFFFFFFFFEBAAEDCE6AF48A03BBFD25E8CD0364140", "Satoshi Nakamoto", "33A19B60E25FB6F4435AF53A3D42D493644827367E6453928554F43E49AA6F90"},
+		{"F8B8AF8CE3C7CCA5E300D33939540C10D45CE001B8F252BFBC57BA0342904181", "Alan Turing", "525A82B70E67874398067543FD84C83D30C175FDC45FDEEE082FE13B1D7CFDF1"},
+	};
+	for (const TestCase &tc : cases) {
+		Rfc6979 gen(Uint256(tc.privateKey), hashString(tc.message));
+		assert(gen.next() == Uint256(tc.nonce));
+		numTestCases++;
+	}
+}
+
+
+static void testKnownSignatures() {
+	struct TestCase {
+		const char *privateKey;
+		const char *message;
+		const char *expectedR;
+		const char *expectedS;
+	};
+	const vector<TestCase> cases{
+		{"0000000000000000000000000000000000000000000000000000000000000001", "Satoshi Nakamoto", "934B1EA10A4B3C1757E2B0C017D0B6143CE3C9A7E6A4A49860D7A6AB210EE3D8", "2442CE9D2B916064108014783E923EC36B49743E2FFA1C4496F01A512AAFD9E5"},
+	};
+	for (const TestCase &tc : cases) {
+		const Uint256 privateKey(tc.privateKey);
+		const Sha256Hash msgHash = hashString(tc.message);
+		Uint256 r, s;
+		Ecdsa::signWithRfc6979Nonce(privateKey, msgHash, r, s);
+		assert(r == Uint256(tc.expectedR) && s == Uint256(tc.expectedS));
+		assert(Ecdsa::verify(CurvePoint::privateExponentToPublicPoint(privateKey), msgHash, r, s));
+		numTestCases++;
+	}
+}
+
+
+static void testRetryAndExtraData() {
+	const Uint256 privateKey("C85AFBACCF3E1EE40BDCD721A9AD1341344775D51840EFC0511E0182AE92F78E");
+	const Sha256Hash msgHash = hashString("retry");
+	
+	// Successive nonces are distinct and repeatable
+	Rfc6979 gen0(privateKey, msgHash);
+	Rfc6979 gen1(privateKey, msgHash);
+	vector<Uint256> nonces;
+	for (int i = 0; i < 5; i++) {
+		Uint256 k = gen0.next();
+		assert(gen1.next() == k);
+		for (const Uint256 &other : nonces)
+			assert(other != k);
+		nonces.push_back(k);
+		numTestCases++;
+	}
+	
+	// Extra data changes the nonce, and empty extra data does not
+	const uint8_t extra[Sha256Hash::HASH_LEN] = {0x01};
+	Rfc6979 gen2(privateKey, msgHash, extra, sizeof(extra));
+	assert(gen2.next() != nonces[0]);
+	Rfc6979 gen3(privateKey, msgHash, extra, 0);
+	assert(gen3.next() == nonces[0]);
+	Uint256 r, s;
+	Ecdsa::signWithRfc6979Nonce(privateKey, msgHash, r, s, extra, sizeof(extra));
+	assert(Ecdsa::verify(CurvePoint::privateExponentToPublicPoint(privateKey), msgHash, r, s));
+	numTestCases++;
+}
+
+
+int main() {
+	testKnownNonces();
+	testKnownSignatures();
+	testRetryAndExtraData();
+	std::printf("All %d test cases passed\n", numTestCases);
+	return EXIT_SUCCESS;
+}
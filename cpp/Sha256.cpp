@@ -68,34 +68,32 @@ Sha256Hash Sha256::getDoubleHash(const uint8_t msg[], size_t len) {
 
 Sha256Hash Sha256::getHmac(const uint8_t key[], size_t keyLen, const uint8_t msg[], size_t msgLen) {
 	assert(key != nullptr || keyLen == 0);
-	
-	// Preprocess key
-	uint8_t tempKey[BLOCK_LEN] = {};
-	if (keyLen <= BLOCK_LEN)
-		Utils::copyBytes(tempKey, key, keyLen);
-	else {
+	if (keyLen > BLOCK_LEN) {
 		const Sha256Hash keyHash = getHash(key, keyLen);
-		std::memcpy(tempKey, keyHash.value, Sha256Hash::HASH_LEN);
+		return getHmac(keyHash.value, Sha256Hash::HASH_LEN, msg, msgLen);
 	}
-	
-	// Compute inner hash
-	for (int i = 0; i < BLOCK_LEN; i++)
-		tempKey[i] ^= 0x36;
-	const Sha256Hash innerHash = Sha256()
-		.append(tempKey, BLOCK_LEN)
+	const Sha256Hash innerHash = getHmacKeyedHasher(key, keyLen, 0x36)
 		.append(msg, msgLen)
 		.getHash();
-	
-	// Compute outer hash
-	for (int i = 0; i < BLOCK_LEN; i++)
-		tempKey[i] ^= 0x36 ^ 0x5C;
-	return Sha256()
-		.append(tempKey, BLOCK_LEN)
+	return getHmacKeyedHasher(key, keyLen, 0x5C)
 		.append(innerHash.value, Sha256Hash::HASH_LEN)
 		.getHash();
 }
 
 
+Sha256 Sha256::getHmacKeyedHasher(const uint8_t key[], size_t keyLen, uint8_t pad) {
+	assert((key != nullptr || keyLen == 0) && keyLen <= BLOCK_LEN);
+	uint8_t block[BLOCK_LEN] = {};
+	Utils::copyBytes(block, key, keyLen);
+	for (int i = 0; i < BLOCK_LEN; i++)
+		block[i] ^= pad;
+	Sha256 result;
+	result.append(block, BLOCK_LEN);
+	Utils::secureZero(block, sizeof(block));
+	return result;
+}
+
+
 void Sha256::compress(uint32_t state[8], const uint8_t block[BLOCK_LEN]) {
 	assert(state != nullptr && block != nullptr);
 	
@@ -60,6 +60,12 @@ class Sha256 final {
 	public: static Sha256Hash getHmac(const std::uint8_t key[], std::size_t keyLen, const std::uint8_t msg[], std::size_t msgLen);
 	
 	
+	// Returns a hasher that has absorbed the given key of at most BLOCK_LEN bytes, zero-padded to a block, XOR the given
+	// byte. With pad 0x36 or 0x5C, this is the HMAC inner or outer state for the key, which can be copied to hash many
+	// messages under the same key. The padded key block is zeroized afterward. Constant-time with respect to the key.
+	public: static Sha256 getHmacKeyedHasher(const std::uint8_t key[], std::size_t keyLen, std::uint8_t pad);
+	
+	
 	public: static void compress(std::uint32_t state[8], const std::uint8_t block[BLOCK_LEN]);
 	
 	
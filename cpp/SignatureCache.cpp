@@ -0,0 +1,185 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include <random>
+#include <utility>
+#include "SignatureCache.hpp"
+
+using std::size_t;
+using std::uint8_t;
+using std::uint32_t;
+using std::uint64_t;
+
+
+SignatureCache::SignatureCache(size_t memLimit) :
+		size(0),
+		maxDisplacements(1),
+		nextKick(0),
+		hits(0),
+		misses(0),
+		evictions(0) {
+	size_t capacity = memLimit / ENTRY_SIZE;
+	if (capacity < 1)
+		capacity = 1;
+	if (capacity > UINT32_MAX)  // Keeps getPositions() exact
+		capacity = UINT32_MAX;
+	slots.resize(capacity);
+	occupied.resize(capacity, false);
+	// About log2(capacity) moves, after which a free slot is unlikely to turn up
+	while (maxDisplacements < 32 && (static_cast<size_t>(1) << maxDisplacements) < capacity)
+		maxDisplacements++;
+	
+	// The salt fills a whole block, so each key costs only the compressions of the tuple
+	uint8_t saltBlock[Sha256::BLOCK_LEN] = {};
+	std::random_device rand;
+	for (int i = 0; i < 32; i += 4) {
+		uint32_t word = rand();
+		for (int j = 0; j < 4; j++)
+			saltBlock[i + j] = static_cast<uint8_t>(word >> (j * 8));
+	}
+	saltedHasher.append(saltBlock, sizeof(saltBlock));
+}
+
+
+bool SignatureCache::contains(const CurvePoint &publicKey, const Sha256Hash &msgHash, const Uint256 &r, const Uint256 &s) {
+	const KeyBytes key = computeKey(publicKey, msgHash, r, s);
+	size_t positions[NUM_POSITIONS];
+	getPositions(key, positions);
+	bool found = false;
+	{
+		std::lock_guard<std::mutex> lock(mutex);
+		for (int i = 0; i < NUM_POSITIONS && !found; i++)
+			found = occupied[positions[i]] && slots[positions[i]] == key;
+	}
+	if (found)
+		hits++;
+	else
+		misses++;
+	return found;
+}
+
+
+void SignatureCache::insert(const CurvePoint &publicKey, const Sha256Hash &msgHash, const Uint256 &r, const Uint256 &s) {
+	/* 
+	 * Algorithm pseudocode:
+	 * if (key is in one of its slots) return
+	 * if (one of its slots is free) { put key there; return }
+	 * p = one of its slots
+	 * repeat maxDisplacements times:
+	 *   swap(key, slot[p])  // Now key is the displaced entry
+	 *   if (one of its slots is free) { put key there; return }
+	 *   p = its slot after p
+	 * drop key
+	 */
+	KeyBytes key = computeKey(publicKey, msgHash, r, s);
+	size_t positions[NUM_POSITIONS];
+	getPositions(key, positions);
+	std::lock_guard<std::mutex> lock(mutex);
+	for (int i = 0; i < NUM_POSITIONS; i++) {
+		if (occupied[positions[i]] && slots[positions[i]] == key)
+			return;
+	}
+	
+	size_t pos = positions[nextKick % NUM_POSITIONS];
+	nextKick++;
+	for (int depth = 0; ; depth++) {
+		for (int i = 0; i < NUM_POSITIONS; i++) {
+			size_t p = positions[i];
+			if (!occupied[p]) {
+				slots[p] = key;
+				occupied[p] = true;
+				size++;
+				return;
+			}
+		}
+		if (depth == maxDisplacements)
+			break;
+		std::swap(key, slots[pos]);
+		getPositions(key, positions);
+		// The displaced entry moves on to its candidate slot after the one it was taken out of
+		int i = 0;
+		while (positions[i] != pos)
+			i++;
+		pos = positions[(i + 1) % NUM_POSITIONS];
+	}
+	evictions++;
+}
+
+
+size_t SignatureCache::getSize() const {
+	std::lock_guard<std::mutex> lock(mutex);
+	return size;
+}
+
+
+size_t SignatureCache::getCapacity() const {
+	return slots.size();
+}
+
+
+uint64_t SignatureCache::getHits() const {
+	return hits.load();
+}
+
+
+uint64_t SignatureCache::getMisses() const {
+	return misses.load();
+}
+
+
+double SignatureCache::getHitRate() const {
+	uint64_t h = hits.load();
+	uint64_t total = h + misses.load();
+	return total > 0 ? static_cast<double>(h) / total : 0.0;
+}
+
+
+uint64_t SignatureCache::getEvictions() const {
+	return evictions.load();
+}
+
+
+void SignatureCache::clear() {
+	std::lock_guard<std::mutex> lock(mutex);
+	occupied.assign(occupied.size(), false);
+	size = 0;
+}
+
+
+SignatureCache::KeyBytes SignatureCache::computeKey(const CurvePoint &publicKey, const Sha256Hash &msgHash,
+		const Uint256 &r, const Uint256 &s) const {
+	// The whole point is hashed, because an invalid point can share its compressed encoding with a valid one
+	uint8_t buf[65 + Sha256Hash::HASH_LEN + 32 + 32];
+	publicKey.toUncompressedPoint(&buf[0]);
+	for (int i = 0; i < Sha256Hash::HASH_LEN; i++)
+		buf[65 + i] = msgHash.value[i];
+	r.getBigEndianBytes(&buf[65 + Sha256Hash::HASH_LEN]);
+	s.getBigEndianBytes(&buf[65 + Sha256Hash::HASH_LEN + 32]);
+	
+	Sha256 hasher(saltedHasher);
+	const Sha256Hash hash = hasher.append(buf, sizeof(buf)).getHash();
+	KeyBytes result;
+	for (int i = 0; i < Sha256Hash::HASH_LEN; i++)
+		result[i] = hash.value[i];
+	return result;
+}
+
+
+void SignatureCache::getPositions(const KeyBytes &key, size_t positions[NUM_POSITIONS]) const {
+	// The key is uniformly random, so scaling each word by the capacity spreads the positions evenly
+	for (int i = 0; i < NUM_POSITIONS; i++) {
+		uint32_t word = 0;
+		for (int j = 0; j < 4; j++)
+			word |= static_cast<uint32_t>(key[i * 4 + j]) << (j * 8);
+		positions[i] = static_cast<size_t>((static_cast<uint64_t>(word) * slots.size()) >> 32);
+	}
+}
+
+
+// Static initializers
+const size_t SignatureCache::ENTRY_SIZE = sizeof(KeyBytes) + 1;  // Key and a rounded-up occupancy bit
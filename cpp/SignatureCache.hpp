@@ -0,0 +1,127 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#pragma once
+
+#include <array>
+#include <atomic>
+#include <cstddef>
+#include <cstdint>
+#include <mutex>
+#include <vector>
+#include "CurvePoint.hpp"
+#include "Sha256.hpp"
+#include "Sha256Hash.hpp"
+#include "Uint256.hpp"
+
+
+/* 
+ * A bounded, thread-safe set of signatures that are known to be valid, so that a signature seen twice (such as
+ * when a transaction is relayed and later mined in a block) is only verified once. Each entry is a 32-byte
+ * SHA-256 hash of a secret random salt and the whole signed tuple (public key, message hash, r, s), so entries
+ * are small and an attacker cannot craft tuples that collide in the table. The table is a cuckoo hash set:
+ * each entry can live in any of NUM_POSITIONS slots, and inserting into a full neighborhood moves old entries
+ * to their other slots, evicting one only after a bounded number of moves. Install one with
+ * Ecdsa::setSignatureCache() to have Ecdsa::verify() and verifyBatch() consult it automatically.
+ * All methods may be called concurrently.
+ */
+class SignatureCache final {
+	
+	/*---- Public constants ----*/
+	
+	public: static constexpr int NUM_POSITIONS = 8;  // Candidate slots per entry
+	
+	
+	
+	/*---- Fields ----*/
+	
+	private: using KeyBytes = std::array<std::uint8_t, Sha256Hash::HASH_LEN>;
+	
+	private: Sha256 saltedHasher;  // Has absorbed one block holding the random salt
+	
+	private: mutable std::mutex mutex;
+	private: std::vector<KeyBytes> slots;
+	private: std::vector<bool> occupied;
+	private: std::size_t size;
+	private: int maxDisplacements;
+	private: unsigned int nextKick;  // Rotates which candidate slot is taken over when all are occupied
+	
+	private: std::atomic<std::uint64_t> hits;
+	private: std::atomic<std::uint64_t> misses;
+	private: std::atomic<std::uint64_t> evictions;
+	
+	
+	
+	/*---- Constructors ----*/
+	
+	// Constructs an empty cache with memoryLimit / ENTRY_SIZE slots (at least one), and a fresh random salt.
+	public: explicit SignatureCache(std::size_t memLimit);
+	
+	
+	SignatureCache(const SignatureCache &) = delete;
+	SignatureCache &operator=(const SignatureCache &) = delete;
+	
+	
+	
+	/*---- Methods ----*/
+	
+	// Returns whether the given signature tuple was inserted before and not yet evicted, and counts a hit or miss.
+	// The public key must be normalized. Not constant-time.
+	public: bool contains(const CurvePoint &publicKey, const Sha256Hash &msgHash, const Uint256 &r, const Uint256 &s);
+	
+	
+	// Records the given signature tuple as valid; the caller must have verified it. The public key must be
+	// normalized. If all candidate slots are taken, entries are moved, and the entry left over after
+	// the maximum number of moves is evicted. Not constant-time.
+	public: void insert(const CurvePoint &publicKey, const Sha256Hash &msgHash, const Uint256 &r, const Uint256 &s);
+	
+	
+	// Returns the number of entries currently cached.
+	public: std::size_t getSize() const;
+	
+	
+	// Returns the number of slots, which is the most entries the cache can hold.
+	public: std::size_t getCapacity() const;
+	
+	
+	// Returns the number of contains() calls that returned true.
+	public: std::uint64_t getHits() const;
+	
+	
+	// Returns the number of contains() calls that returned false.
+	public: std::uint64_t getMisses() const;
+	
+	
+	// Returns hits / (hits + misses), or 0 if contains() has not been called.
+	public: double getHitRate() const;
+	
+	
+	// Returns the number of entries dropped by insert() to make room.
+	public: std::uint64_t getEvictions() const;
+	
+	
+	// Removes all entries, but leaves the counters and salt unchanged.
+	public: void clear();
+	
+	
+	// Returns the salted hash of the given signature tuple.
+	private: KeyBytes computeKey(const CurvePoint &publicKey, const Sha256Hash &msgHash,
+		const Uint256 &r, const Uint256 &s) const;
+	
+	
+	// Computes the candidate slot indexes of the given key, one from each of its 32-bit words.
+	private: void getPositions(const KeyBytes &key, std::size_t positions[NUM_POSITIONS]) const;
+	
+	
+	
+	/*---- Class constants ----*/
+	
+	// Approximate number of bytes used by each slot.
+	public: static const std::size_t ENTRY_SIZE;
+	
+};
@@ -0,0 +1,191 @@
+/* 
+ * A runnable main program that tests the functionality of class SignatureCache.
+ * 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include "TestHelper.hpp"
+#include <cstdio>
+#include <cstdlib>
+#include <thread>
+#include "CurvePoint.hpp"
+#include "Ecdsa.hpp"
+#include "SignatureCache.hpp"
+#include "Sha256.hpp"
+#include "Sha256Hash.hpp"
+#include "Uint256.hpp"
+
+using std::uint8_t;
+using std::uint64_t;
+
+
+// Global variables
+static int numTestCases = 0;
+
+
+// Returns the hash of the given one-byte message.
+static Sha256Hash hashOf(uint8_t b) {
+	return Sha256::getHash(&b, 1);
+}
+
+
+/*---- Test cases ----*/
+
+static void testContainsAndInsert() {
+	SignatureCache cache(100 * SignatureCache::ENTRY_SIZE);
+	assert(cache.getCapacity() == 100 && cache.getSize() == 0);
+	const Sha256Hash msgHash = hashOf(0);
+	Uint256 r, s;
+	assert(Ecdsa::signWithHmacNonce(Uint256::ONE, msgHash, r, s));
+	assert(!cache.contains(CurvePoint::G, msgHash, r, s));
+	cache.insert(CurvePoint::G, msgHash, r, s);
+	cache.insert(CurvePoint::G, msgHash, r, s);  // Already present
+	assert(cache.getSize() == 1);
+	assert(cache.contains(CurvePoint::G, msgHash, r, s));
+	numTestCases++;
+	
+	// Changing any part of the tuple misses
+	Uint256 other = r;
+	other.add(Uint256::ONE);
+	assert(!cache.contains(CurvePoint::G, msgHash, other, s));
+	assert(!cache.contains(CurvePoint::G, msgHash, r, other));
+	assert(!cache.contains(CurvePoint::G, hashOf(1), r, s));
+	CurvePoint pt = CurvePoint::G;
+	pt.twice();
+	pt.normalize();
+	assert(!cache.contains(pt, msgHash, r, s));
+	// Same compressed encoding as G, but not on the curve
+	FieldInt y = CurvePoint::G.y;
+	y.add(FieldInt("0000000000000000000000000000000000000000000000000000000000000002"));
+	assert(!cache.contains(CurvePoint(CurvePoint::G.x, y), msgHash, r, s));
+	numTestCases++;
+	
+	assert(cache.getHits() == 1 && cache.getMisses() == 6);
+	assert(cache.getHitRate() == 1.0 / 7);
+	assert(cache.getEvictions() == 0);
+	numTestCases++;
+	
+	cache.clear();
+	assert(cache.getSize() == 0 && !cache.contains(CurvePoint::G, msgHash, r, s));
+	numTestCases++;
+}
+
+
+static void testEviction() {
+	// Fill far past the capacity; fake tuples are fine since the cache does not verify
+	SignatureCache cache(64 * SignatureCache::ENTRY_SIZE);
+	const Sha256Hash msgHash = hashOf(0);
+	for (int i = 0; i < 1000; i++) {
+		Uint256 r(Uint256::ONE);
+		for (int j = 0; j < i; j++)
+			r.add(Uint256::ONE);
+		cache.insert(CurvePoint::G, msgHash, r, Uint256::ONE);
+		assert(cache.getSize() <= 64);
+		assert(cache.getSize() + cache.getEvictions() == static_cast<uint64_t>(i) + 1);
+	}
+	assert(cache.getSize() == 64 && cache.getEvictions() == 1000 - 64);
+	numTestCases++;
+	
+	// Cuckoo moves keep the table nearly full before anything is evicted
+	SignatureCache big(1024 * SignatureCache::ENTRY_SIZE);
+	Uint256 r(Uint256::ONE);
+	while (big.getEvictions() == 0) {
+		big.insert(CurvePoint::G, msgHash, r, Uint256::ONE);
+		r.add(Uint256::ONE);
+	}
+	assert(big.getSize() >= 900);
+	numTestCases++;
+	
+	SignatureCache tiny(0);
+	assert(tiny.getCapacity() == 1);
+	tiny.insert(CurvePoint::G, msgHash, Uint256::ONE, Uint256::ONE);
+	tiny.insert(CurvePoint::G, msgHash, r, Uint256::ONE);
+	assert(tiny.getSize() == 1 && tiny.getEvictions() == 1);
+	numTestCases++;
+}
+
+
+static void testSalting() {
+	SignatureCache cache0(16 * SignatureCache::ENTRY_SIZE);
+	SignatureCache cache1(16 * SignatureCache::ENTRY_SIZE);
+	const Sha256Hash msgHash = hashOf(0);
+	cache0.insert(CurvePoint::G, msgHash, Uint256::ONE, Uint256::ONE);
+	assert(cache0.contains(CurvePoint::G, msgHash, Uint256::ONE, Uint256::ONE));
+	assert(!cache1.contains(CurvePoint::G, msgHash, Uint256::ONE, Uint256::ONE));
+	numTestCases++;
+}
+
+
+static void testVerifyWithCache() {
+	SignatureCache cache(256 * SignatureCache::ENTRY_SIZE);
+	Ecdsa::setSignatureCache(&cache);
+	constexpr int numMsgs = 8;
+	Uint256 rs[numMsgs], ss[numMsgs];
+	vector<Sha256Hash> msgHashes;
+	for (int i = 0; i < numMsgs; i++) {
+		msgHashes.push_back(hashOf(static_cast<uint8_t>(i)));
+		assert(Ecdsa::signWithHmacNonce(Uint256::ONE, msgHashes[i], rs[i], ss[i]));
+	}
+	
+	// Only valid signatures are cached, and a hit gives the same result
+	assert(Ecdsa::verify(CurvePoint::G, msgHashes[0], rs[0], ss[0]));
+	assert(cache.getSize() == 1 && cache.getHits() == 0 && cache.getMisses() == 1);
+	assert(Ecdsa::verify(CurvePoint::G, msgHashes[0], rs[0], ss[0]));
+	assert(cache.getHits() == 1);
+	assert(!Ecdsa::verify(CurvePoint::G, msgHashes[1], rs[0], ss[0]));
+	assert(!Ecdsa::verify(CurvePoint::G, msgHashes[1], rs[0], ss[0]));
+	assert(cache.getSize() == 1 && cache.getHits() == 1 && cache.getMisses() == 3);
+	numTestCases++;
+	
+	// Batches skip cached items and add the newly verified ones
+	vector<CurvePoint> pubKeys(numMsgs, CurvePoint::G);
+	bool results[numMsgs];
+	ss[numMsgs - 1].add(Uint256::ONE);
+	Ecdsa::verifyBatch(pubKeys.data(), msgHashes.data(), rs, ss, numMsgs, results);
+	for (int i = 0; i < numMsgs; i++)
+		assert(results[i] == (i != numMsgs - 1));
+	assert(cache.getSize() == numMsgs - 1 && cache.getHits() == 2);
+	Ecdsa::verifyBatch(pubKeys.data(), msgHashes.data(), rs, ss, numMsgs, results);
+	for (int i = 0; i < numMsgs; i++)
+		assert(results[i] == (i != numMsgs - 1));
+	assert(cache.getHits() == 2 + numMsgs - 1);
+	numTestCases++;
+	
+	// Concurrent verifications
+	vector<std::thread> threads;
+	bool failed[4] = {};
+	for (int t = 0; t < 4; t++) {
+		threads.push_back(std::thread([&, t]() {
+			for (int i = 0; i < numMsgs; i++) {
+				if (Ecdsa::verify(CurvePoint::G, msgHashes[i], rs[i], ss[i]) != (i != numMsgs - 1))
+					failed[t] = true;
+			}
+		}));
+	}
+	for (std::thread &th : threads)
+		th.join();
+	for (bool f : failed)
+		assert(!f);
+	assert(cache.getSize() == numMsgs - 1);
+	numTestCases++;
+	
+	Ecdsa::setSignatureCache(nullptr);
+	uint64_t total = cache.getHits() + cache.getMisses();
+	assert(Ecdsa::verify(CurvePoint::G, msgHashes[0], rs[0], ss[0]));
+	assert(cache.getHits() + cache.getMisses() == total);
+	numTestCases++;
+}
+
+
+int main() {
+	testContainsAndInsert();
+	testEviction();
+	testSalting();
+	testVerifyWithCache();
+	std::printf("All %d test cases passed\n", numTestCases);
+	return EXIT_SUCCESS;
+}
@@ -17,6 +17,11 @@
 #include <cstdint>
 #include <cstring>
 #include <vector>
+#include "CurvePoint.hpp"
+#include "Ecdsa.hpp"
+#include "Sha256.hpp"
+#include "Sha256Hash.hpp"
+#include "Uint256.hpp"
 
 using std::size_t;
 using std::vector;
@@ -40,3 +45,27 @@ Bytes hexBytes(const char *str) {
 	}
 	return result;
 }
+
+
+struct TestSignature {
+	CurvePoint publicKey;
+	Sha256Hash msgHash;
+	Uint256 r;
+	Uint256 s;
+	bool valid;
+};
+
+
+// Returns a signature of a message derived from i, by one of 256 keys also derived from i.
+// If valid is false, then s is corrupted so that the signature fails verification.
+TestSignature makeTestSignature(unsigned int i, bool valid) {
+	std::uint8_t msg[2] = {static_cast<std::uint8_t>(i), static_cast<std::uint8_t>(i >> 8)};
+	Uint256 privKey(Sha256::getHash(msg, 1).value);
+	privKey.subtract(CurvePoint::ORDER, static_cast<std::uint32_t>(privKey >= CurvePoint::ORDER));
+	const Sha256Hash msgHash = Sha256::getHash(msg, sizeof(msg));
+	Uint256 r, s;
+	Ecdsa::signWithRfc6979Nonce(privKey, msgHash, r, s);
+	if (!valid)
+		s.add(Uint256::ONE);
+	return TestSignature{CurvePoint::privateExponentToPublicPoint(privKey), msgHash, r, s, valid};
+}
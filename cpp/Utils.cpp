@@ -38,4 +38,11 @@ void Utils::storeBigUint32(std::uint32_t x, uint8_t arr[4]) {
 }
 
 
+void Utils::secureZero(void *dest, std::size_t count) {
+	volatile uint8_t *p = static_cast<volatile uint8_t *>(dest);
+	for (std::size_t i = 0; i < count; i++)
+		p[i] = 0;
+}
+
+
 const char *Utils::HEX_DIGITS = "0123456789abcdef";
@@ -37,6 +37,11 @@ class Utils final {
 	public: static void storeBigUint32(std::uint32_t x, std::uint8_t arr[4]);
 	
 	
+	// Sets the given bytes to zero through a volatile pointer, so that the stores are not removed as dead
+	// even if the memory is never read again. Used to erase secret data.
+	public: static void secureZero(void *dest, std::size_t count);
+	
+	
 	Utils() = delete;  // Not instantiable
 	
 };
@@ -0,0 +1,146 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include <algorithm>
+#include <cassert>
+#include "Ecdsa.hpp"
+#include "VerifyPool.hpp"
+
+using std::size_t;
+
+
+VerifyPool::Batch::Batch() :
+	pendingTasks(0),
+	allValid(true) {}
+
+
+VerifyPool::VerifyPool(int numThreads) :
+		queuedTasks(0),
+		nextQueue(0),
+		stopping(false) {
+	if (numThreads == 0)
+		numThreads = std::max(static_cast<int>(std::thread::hardware_concurrency()), 1);
+	size_t numQueues = static_cast<size_t>(std::max(numThreads, 1));
+	for (size_t i = 0; i < numQueues; i++)
+		queues.emplace_back(new Queue);
+	for (int i = 0; i < numThreads; i++)
+		threads.emplace_back(&VerifyPool::workerLoop, this, static_cast<size_t>(i));
+}
+
+
+VerifyPool::~VerifyPool() {
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);
+		stopping = true;
+	}
+	workAvailable.notify_all();
+	for (std::thread &th : threads)
+		th.join();
+	// Without worker threads, run what is left here
+	Task task;
+	while (takeTask(0, task))
+		runTask(task);
+}
+
+
+void VerifyPool::submit(Batch &batch, const CurvePoint publicKeys[], const Sha256Hash msgHashes[],
+		const Uint256 rs[], const Uint256 ss[], size_t n, bool results[]) {
+	assert((publicKeys != nullptr && msgHashes != nullptr && rs != nullptr && ss != nullptr && results != nullptr) || n == 0);
+	size_t numTasks = (n + TASK_LEN - 1) / TASK_LEN;
+	if (numTasks == 0)
+		return;
+	batch.pendingTasks += numTasks;  // Before any task can finish
+	size_t q = nextQueue.fetch_add(numTasks);
+	for (size_t i = 0; i < n; i += TASK_LEN, q++) {
+		size_t len = TASK_LEN;
+		if (n - i < len)
+			len = n - i;
+		Task task = {&batch, &publicKeys[i], &msgHashes[i], &rs[i], &ss[i], len, &results[i]};
+		Queue &queue = *queues[q % queues.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		queue.tasks.push_back(task);
+		queuedTasks++;
+	}
+	{
+		std::lock_guard<std::mutex> lock(sleepMutex);  // So that a thread about to sleep sees the new tasks
+	}
+	workAvailable.notify_all();
+	batchFinished.notify_all();  // Waiters run tasks too, and might be the only threads that can
+}
+
+
+bool VerifyPool::wait(Batch &batch) {
+	while (batch.pendingTasks.load() > 0) {
+		Task task;
+		if (takeTask(nextQueue.load() % queues.size(), task)) {
+			runTask(task);
+			continue;
+		}
+		// Every remaining task of the batch is running in another thread; sleep until they
+		// finish or until more tasks are queued (possibly into this batch by another thread)
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		batchFinished.wait(lock, [this, &batch]() { return batch.pendingTasks.load() == 0 || queuedTasks.load() > 0; });
+	}
+	return batch.allValid.exchange(true);
+}
+
+
+int VerifyPool::getNumThreads() const {
+	return static_cast<int>(threads.size());
+}
+
+
+void VerifyPool::workerLoop(size_t index) {
+	while (true) {
+		Task task;
+		if (takeTask(index, task)) {
+			runTask(task);
+			continue;
+		}
+		std::unique_lock<std::mutex> lock(sleepMutex);
+		workAvailable.wait(lock, [this]() { return stopping || queuedTasks.load() > 0; });
+		if (stopping && queuedTasks.load() == 0)
+			return;
+	}
+}
+
+
+bool VerifyPool::takeTask(size_t index, Task &out) {
+	if (queuedTasks.load() == 0)
+		return false;
+	for (size_t i = 0; i < queues.size(); i++) {
+		Queue &queue = *queues[(index + i) % queues.size()];
+		std::lock_guard<std::mutex> lock(queue.mutex);
+		if (queue.tasks.empty())
+			continue;
+		if (i == 0) {  // Own queue: newest task, whose data is most likely still in cache
+			out = queue.tasks.back();
+			queue.tasks.pop_back();
+		} else {  // Steal the oldest task
+			out = queue.tasks.front();
+			queue.tasks.pop_front();
+		}
+		queuedTasks--;
+		return true;
+	}
+	return false;
+}
+
+
+void VerifyPool::runTask(const Task &task) {
+	Ecdsa::verifyBatch(task.publicKeys, task.msgHashes, task.rs, task.ss, task.n, task.results);
+	bool valid = true;
+	for (size_t i = 0; i < task.n; i++)
+		valid &= task.results[i];
+	if (!valid)
+		task.batch->allValid.store(false);
+	if (task.batch->pendingTasks.fetch_sub(1) == 1) {
+		std::lock_guard<std::mutex> lock(sleepMutex);  // So that a waiter cannot miss the notification
+		batchFinished.notify_all();
+	}
+}
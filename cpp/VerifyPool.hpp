@@ -0,0 +1,148 @@
+/* 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#pragma once
+
+#include <atomic>
+#include <condition_variable>
+#include <cstddef>
+#include <deque>
+#include <memory>
+#include <mutex>
+#include <thread>
+#include <vector>
+#include "CurvePoint.hpp"
+#include "Sha256Hash.hpp"
+#include "Uint256.hpp"
+
+
+/* 
+ * A pool of threads that verify ECDSA signatures in the background. Each submitted batch is cut into tasks of
+ * TASK_LEN signatures (each checked with Ecdsa::verifyBatch()), which are dealt round-robin onto per-thread
+ * queues. A thread takes tasks from the back of its own queue and, when that is empty, steals from the front
+ * of the others, so all threads stay busy even when signature costs vary (for example with cached keys).
+ * A thread waiting for a batch also runs queued tasks instead of blocking. All methods may be called
+ * concurrently. Example usage:
+ *   VerifyPool pool(0);  // One thread per core
+ *   VerifyPool::Batch batch;
+ *   pool.submit(batch, publicKeys, msgHashes, rs, ss, n, results);
+ *   ... submit more, or do other work ...
+ *   bool allValid = pool.wait(batch);  // Now results[i] is set
+ */
+class VerifyPool final {
+	
+	/*---- Public constants ----*/
+	
+	public: static constexpr std::size_t TASK_LEN = 16;  // Signatures per task
+	
+	
+	
+	/*---- Helper class ----*/
+	
+	// Tracks the completion of the signatures submitted with it. A batch can be used for any number
+	// of submissions before wait(), and reused afterward. It must not be destroyed while pending.
+	public: class Batch final {
+		
+		private: std::atomic<std::size_t> pendingTasks;
+		private: std::atomic<bool> allValid;
+		
+		// Constructs a batch with nothing pending.
+		public: explicit Batch();
+		
+		public: Batch(const Batch &other) = delete;
+		
+		public: Batch &operator=(const Batch &other) = delete;
+		
+		friend class VerifyPool;
+	
+	};
+	
+	
+	
+	/*---- Types ----*/
+	
+	private: struct Task {
+		Batch *batch;
+		const CurvePoint *publicKeys;
+		const Sha256Hash *msgHashes;
+		const Uint256 *rs;
+		const Uint256 *ss;
+		std::size_t n;
+		bool *results;
+	};
+	
+	private: struct Queue {
+		std::mutex mutex;
+		std::deque<Task> tasks;
+	};
+	
+	
+	
+	/*---- Fields ----*/
+	
+	private: std::vector<std::unique_ptr<Queue> > queues;  // One per worker thread, at least one
+	private: std::vector<std::thread> threads;
+	private: std::atomic<std::size_t> queuedTasks;
+	private: std::atomic<std::size_t> nextQueue;  // For dealing tasks round-robin
+	
+	private: std::mutex sleepMutex;  // Guards stopping and the waits on the condition variables
+	private: std::condition_variable workAvailable;
+	private: std::condition_variable batchFinished;
+	private: bool stopping;
+	
+	
+	
+	/*---- Constructors ----*/
+	
+	// Starts the given number of worker threads, or one per hardware thread if numThreads is 0.
+	// With numThreads < 0, no threads are started and wait() does all the work in the calling thread.
+	public: explicit VerifyPool(int numThreads);
+	
+	
+	// Finishes all submitted tasks, then stops the worker threads.
+	public: ~VerifyPool();
+	
+	
+	public: VerifyPool(const VerifyPool &other) = delete;
+	
+	public: VerifyPool &operator=(const VerifyPool &other) = delete;
+	
+	
+	
+	/*---- Methods ----*/
+	
+	// Queues the verification of n signatures into the given batch; results[i] will be set to what Ecdsa::verify()
+	// returns for the i-th public key (which must be normalized), message hash, r, and s. All the arrays must stay
+	// valid and unchanged, and the results must not be read, until wait() returns for the batch.
+	public: void submit(Batch &batch, const CurvePoint publicKeys[], const Sha256Hash msgHashes[],
+		const Uint256 rs[], const Uint256 ss[], std::size_t n, bool results[]);
+	
+	
+	// Blocks until every signature submitted with the given batch is checked, running queued tasks meanwhile
+	// (including ones that other threads submit while this waits, into any batch).
+	// Returns whether all of them were valid since the previous wait() on this batch, and resets that flag.
+	public: bool wait(Batch &batch);
+	
+	
+	// Returns the number of worker threads.
+	public: int getNumThreads() const;
+	
+	
+	// The main loop of the worker thread with the given queue index.
+	private: void workerLoop(std::size_t index);
+	
+	
+	// Removes a task, preferring the back of the queue at the given index, then the fronts of the others
+	// in order. Returns false if all queues are empty.
+	private: bool takeTask(std::size_t index, Task &out);
+	
+	
+	// Verifies the task's signatures and updates its batch.
+	private: void runTask(const Task &task);
+	
+};
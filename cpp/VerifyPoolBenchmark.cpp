@@ -0,0 +1,89 @@
+/* 
+ * A runnable main program that measures how the throughput of VerifyPool
+ * scales with the number of threads. The optional argument is the largest
+ * number of threads to try (default: the number of hardware threads).
+ * The thread counts include the calling thread, which runs tasks in wait():
+ * a row for N threads uses a pool of N - 1 workers, and the single-thread
+ * baseline uses a pool with no workers at all.
+ * 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include <chrono>
+#include <cstddef>
+#include <cstdint>
+#include <cstdio>
+#include <cstdlib>
+#include <memory>
+#include <thread>
+#include <vector>
+#include "CurvePoint.hpp"
+#include "Ecdsa.hpp"
+#include "Sha256.hpp"
+#include "Sha256Hash.hpp"
+#include "Uint256.hpp"
+#include "VerifyPool.hpp"
+
+using std::size_t;
+using std::uint8_t;
+using std::vector;
+
+
+int main(int argc, char *argv[]) {
+	int maxThreads = static_cast<int>(std::thread::hardware_concurrency());
+	if (argc >= 2)
+		maxThreads = std::atoi(argv[1]);
+	if (maxThreads < 1)
+		maxThreads = 1;
+	
+	// Signatures from 64 keys, like the inputs of a block
+	const size_t numSigs = 2048;
+	vector<CurvePoint> publicKeys;
+	vector<Sha256Hash> msgHashes;
+	vector<Uint256> rs;
+	vector<Uint256> ss;
+	for (size_t i = 0; i < numSigs; i++) {
+		uint8_t msg[2] = {static_cast<uint8_t>(i), static_cast<uint8_t>(i >> 8)};
+		uint8_t keySeed = static_cast<uint8_t>(i % 64);
+		Uint256 privKey(Sha256::getHash(&keySeed, 1).value);
+		privKey.subtract(CurvePoint::ORDER, static_cast<std::uint32_t>(privKey >= CurvePoint::ORDER));
+		const Sha256Hash msgHash = Sha256::getHash(msg, sizeof(msg));
+		Uint256 r, s;
+		Ecdsa::signWithRfc6979Nonce(privKey, msgHash, r, s);
+		publicKeys.push_back(CurvePoint::privateExponentToPublicPoint(privKey));
+		msgHashes.push_back(msgHash);
+		rs.push_back(r);
+		ss.push_back(s);
+	}
+	
+	// Total verifying thread counts 1, 2, 4, ..., and maxThreads
+	vector<int> threadCounts;
+	for (int n = 1; n < maxThreads; n *= 2)
+		threadCounts.push_back(n);
+	threadCounts.push_back(maxThreads);
+	
+	std::printf("Threads  Sigs/s  Speedup\n");
+	std::unique_ptr<bool[]> results(new bool[numSigs]);
+	double baseRate = 0;
+	for (int numThreads : threadCounts) {
+		VerifyPool pool(numThreads > 1 ? numThreads - 1 : -1);  // The caller is the remaining thread
+		VerifyPool::Batch batch;
+		auto start = std::chrono::steady_clock::now();
+		pool.submit(batch, publicKeys.data(), msgHashes.data(), rs.data(), ss.data(), numSigs, results.get());
+		bool ok = pool.wait(batch);
+		double secs = std::chrono::duration<double>(std::chrono::steady_clock::now() - start).count();
+		if (!ok) {
+			std::printf("Verification failed\n");
+			return EXIT_FAILURE;
+		}
+		double rate = numSigs / secs;
+		if (baseRate == 0)
+			baseRate = rate;
+		std::printf("%7d  %6.0f  %7.2f\n", numThreads, rate, rate / baseRate);
+	}
+	return EXIT_SUCCESS;
+}
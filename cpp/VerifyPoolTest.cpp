@@ -0,0 +1,155 @@
+/* 
+ * A runnable main program that tests the functionality of class VerifyPool.
+ * 
+ * Bitcoin cryptography library
+ * Copyright (c) Project Nayuki
+ * 
+ * https://www.nayuki.io/page/bitcoin-cryptography-library
+ * https://github.com/nayuki/Bitcoin-Cryptography-Library
+ */
+
+#include "TestHelper.hpp"
+#include <cstdio>
+#include <chrono>
+#include <cstdlib>
+#include <future>
+#include <thread>
+#include "CurvePoint.hpp"
+#include "Sha256Hash.hpp"
+#include "Uint256.hpp"
+#include "VerifyPool.hpp"
+
+
+// Global variables
+static int numTestCases = 0;
+
+
+/*---- Helper functions ----*/
+
+struct Signatures {
+	vector<CurvePoint> publicKeys;
+	vector<Sha256Hash> msgHashes;
+	vector<Uint256> rs;
+	vector<Uint256> ss;
+	vector<bool> expect;
+};
+
+
+// Returns n signatures from a few keys, where every seventh one is corrupted.
+static Signatures makeSignatures(size_t n) {
+	Signatures result;
+	for (size_t i = 0; i < n; i++) {
+		const TestSignature sig = makeTestSignature(static_cast<unsigned int>(i), i % 7 != 3);
+		result.publicKeys.push_back(sig.publicKey);
+		result.msgHashes.push_back(sig.msgHash);
+		result.rs.push_back(sig.r);
+		result.ss.push_back(sig.s);
+		result.expect.push_back(sig.valid);
+	}
+	return result;
+}
+
+
+/*---- Test cases ----*/
+
+static void testSingleBatch(const Signatures &sigs) {
+	const size_t n = sigs.publicKeys.size();
+	for (int numThreads : {-1, 1, 4}) {
+		VerifyPool pool(numThreads);
+		assert(pool.getNumThreads() == std::max(numThreads, 0));
+		bool results[200];
+		for (size_t len : {static_cast<size_t>(0), static_cast<size_t>(1), VerifyPool::TASK_LEN + 1, n}) {
+			VerifyPool::Batch batch;
+			pool.submit(batch, sigs.publicKeys.data(), sigs.msgHashes.data(), sigs.rs.data(), sigs.ss.data(), len, results);
+			bool allValid = true;
+			for (size_t i = 0; i < len; i++)
+				allValid &= sigs.expect[i];
+			assert(pool.wait(batch) == allValid);
+			for (size_t i = 0; i < len; i++)
+				assert(results[i] == sigs.expect[i]);
+			assert(pool.wait(batch));  // Flag was reset
+			numTestCases++;
+		}
+	}
+}
+
+
+static void testConcurrentBatches(const Signatures &sigs) {
+	const size_t n = sigs.publicKeys.size();
+	VerifyPool pool(3);
+	const int numSubmitters = 4;
+	vector<std::thread> submitters;
+	vector<vector<char> > allResults(numSubmitters, vector<char>(n, 2));
+	for (int t = 0; t < numSubmitters; t++) {
+		submitters.emplace_back([&sigs, &pool, &allResults, n, t]() {
+			bool results[200];
+			VerifyPool::Batch batch;
+			// Two submissions into one batch, in reverse order
+			size_t half = n / 2 + static_cast<size_t>(t);
+			pool.submit(batch, &sigs.publicKeys[half], &sigs.msgHashes[half], &sigs.rs[half], &sigs.ss[half], n - half, &results[half]);
+			pool.submit(batch, sigs.publicKeys.data(), sigs.msgHashes.data(), sigs.rs.data(), sigs.ss.data(), half, results);
+			assert(!pool.wait(batch));
+			for (size_t i = 0; i < n; i++)
+				allResults[t][i] = results[i];
+		});
+	}
+	for (std::thread &th : submitters)
+		th.join();
+	for (const vector<char> &results : allResults) {
+		for (size_t i = 0; i < n; i++)
+			assert((results[i] != 0) == sigs.expect[i]);
+		numTestCases++;
+	}
+}
+
+
+static void testSubmitWhileWaiting(const Signatures &sigs) {
+	// Without worker threads, only callers of wait() run tasks. The main thread's wait() finds no task to take
+	// while another thread's wait() runs the main batch's only task, so it sleeps. Then a third thread submits
+	// into that batch, and the other thread returns without running it; the sleeping wait() must take it over.
+	const size_t len = VerifyPool::TASK_LEN;
+	VerifyPool pool(-1);
+	for (int round = 0; round < 3; round++) {
+		bool results[2 * len];
+		bool otherResult[1];
+		VerifyPool::Batch batch;
+		VerifyPool::Batch otherBatch;
+		std::promise<void> otherSubmitted;
+		std::promise<void> batchSubmitted;
+		std::thread other([&]() {
+			pool.submit(otherBatch, &sigs.publicKeys[2 * len], &sigs.msgHashes[2 * len], &sigs.rs[2 * len], &sigs.ss[2 * len], 1, otherResult);
+			otherSubmitted.set_value();
+			batchSubmitted.get_future().wait();
+			pool.wait(otherBatch);  // Takes the newest task, which is the main batch's
+		});
+		otherSubmitted.get_future().wait();
+		pool.submit(batch, sigs.publicKeys.data(), sigs.msgHashes.data(), sigs.rs.data(), sigs.ss.data(), len, results);
+		batchSubmitted.set_value();
+		std::thread submitter([&]() {
+			std::this_thread::sleep_for(std::chrono::milliseconds(5));
+			pool.submit(batch, &sigs.publicKeys[len], &sigs.msgHashes[len], &sigs.rs[len], &sigs.ss[len], len, &results[len]);
+		});
+		std::this_thread::sleep_for(std::chrono::milliseconds(1));
+		bool allValid = pool.wait(batch);
+		submitter.join();
+		allValid &= pool.wait(batch);  // In case the submission came after the first wait() returned
+		other.join();
+		bool expectValid = true;
+		for (size_t i = 0; i < 2 * len; i++) {
+			assert(results[i] == sigs.expect[i]);
+			expectValid &= sigs.expect[i];
+		}
+		assert(allValid == expectValid && otherResult[0] == sigs.expect[2 * len]);
+		numTestCases++;
+	}
+}
+
+
+int main() {
+	const Signatures sigs = makeSignatures(100);
+	testSingleBatch(sigs);
+	testConcurrentBatches(sigs);
+	testSubmitWhileWaiting(sigs);
+	std::printf("All %d test cases passed\n", numTestCases);
+	return EXIT_SUCCESS;
+}